@@ -0,0 +1,327 @@
+/*
+ * Offscreen benchmark of dashboard pages.
+ *
+ * Whole MainWindow is created and every page of the stacked widget
+ * (drive panel with RpmWidget, Alerts, Statistics with running chart,
+ * Settings) is shown in turn while synthetic candump lines are fed to
+ * Connections at fixed rate. For every page it measures:
+ *  - update: decoding of fed lines (alerts lane is delivered in it) and
+ *    render clock frames (widget updates of telemetry lane),
+ *  - paint: backing store flushes of the window (all widget paints of one
+ *    frame), counted as produced frames,
+ *  - painted area: pixels of paint events of all widgets per second,
+ *  - CPU time of process per second of wall time.
+ *
+ * Startup time (construction of MainWindow and its first paint) is measured
+ * once.
+ *
+ * All pages are measured with full repaint and with partial repaint mode,
+ * painted area reduction of partial repaint is reported for every page.
+ *
+ * Results are printed as JSON, so runs of builds and boards can be compared.
+ *
+ * Usage: QT_QPA_PLATFORM=offscreen bin/vocc_page_bench [-r rate] [-d seconds] [-o file]
+ */
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QTimer>
+#include <QStackedWidget>
+#include <QPushButton>
+#include <QPaintEvent>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSysInfo>
+#include <QFile>
+#include <QtMath>
+#include <unistd.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <ctime>
+
+#include "../src/main/mainwindow.h"
+#include "../src/main/renderscheduler.h"
+#include "../src/main/perfoverlay.h"
+#include "../src/connections/connections.h"
+#include "../src/common/logger.h"
+#include "../src/common/parameters.h"
+#include "../src/common/pipeline.h"
+
+#define DEFAULT_RATE        100     /* CAN frame pairs per second */
+#define DEFAULT_DURATION    3       /* [s] per page */
+#define SETTLE_TIME         300     /* [ms] after page switch */
+#define ALERT_PERIOD        50      /* alert bits change every ALERT_PERIOD updates */
+#define PAGES               4
+
+int gLogMask = 0;
+StageCounter gStages[STAGE_COUNT];
+
+void logger (int level, bool raw, const char *fmt, ...)
+{
+    Q_UNUSED(level);
+    Q_UNUSED(raw);
+    Q_UNUSED(fmt);
+}
+
+void logger (const char *fmt, ...)
+{
+    Q_UNUSED(fmt);
+}
+
+
+/* counts and times backing store flushes of window and paint events of its widgets */
+class FrameProbe : public QObject
+{
+public:
+    explicit FrameProbe(QWidget *window) : mWindow(window), mInside(false) { reset(); }
+
+    void reset(void)
+    {
+        frames = paints = 0;
+        paintNs = paintMaxNs = 0;
+        area = 0;
+    }
+
+    quint64 frames; /// - window flushes (frames produced)
+    quint64 paints; /// - paint events of widgets
+    qint64 paintNs; /// - sum of flush durations [ns]
+    qint64 paintMaxNs; /// - worst flush duration [ns]
+    qint64 area; /// - painted pixels
+
+protected:
+    bool eventFilter(QObject *obj, QEvent *event)
+    {
+        if (event->type() == QEvent::Paint) {
+            paints++;
+            area += PerfOverlay::area(static_cast<QPaintEvent *>(event)->region());
+            return false;
+        }
+
+        /* update request of top level widget paints all dirty widgets */
+        if (event->type() == QEvent::UpdateRequest && obj == mWindow && !mInside) {
+            QElapsedTimer timer;
+            mInside = true;
+            timer.start();
+            obj->event(event);
+            qint64 ns = timer.nsecsElapsed();
+            mInside = false;
+
+            frames++;
+            paintNs += ns;
+            paintMaxNs = qMax(paintMaxNs, ns);
+            return true;
+        }
+
+        return false;
+    }
+
+private:
+    QWidget *mWindow; /// - probed window
+    bool mInside; /// - update request is being delivered by probe
+};
+
+
+/* runs event loop for ms milliseconds */
+static void runFor(int ms)
+{
+    QEventLoop loop;
+    QTimer::singleShot(qMax(0, ms), Qt::PreciseTimer, &loop, &QEventLoop::quit);
+    loop.exec();
+}
+
+
+/* candump lines of one tick - slow sweep of all channels, alerts toggled periodically */
+static QByteArray frames(int i, int rate)
+{
+    double t = double(i) / rate;
+    int rpm = qRound(3000 + 2500 * qSin(t));
+    int current = qRound((70 + 60 * qSin(t * 0.7)) * 10);
+    int voltage = qRound((80 + 6 * qCos(t * 0.3)) * 10);
+    int alerts = ((i / ALERT_PERIOD) % 2) ? 0x0105 : 0x0000;
+    int throttle = qRound(255 * (0.5 + 0.5 * qSin(t * 1.3)));
+    int controllerTemp = qRound(40 + 50 + 20 * qSin(t * 0.1));
+    int motorTemp = qRound(30 + 55 + 15 * qSin(t * 0.2));
+    char line[128];
+    QByteArray data;
+
+    snprintf(line, sizeof(line), "can0  %s   [8]  %02X %02X %02X %02X %02X %02X %02X %02X\n",
+             MESSAGE_1, rpm & 0xff, rpm >> 8, current & 0xff, current >> 8,
+             voltage & 0xff, voltage >> 8, alerts & 0xff, alerts >> 8);
+    data.append(line);
+    snprintf(line, sizeof(line), "can0  %s   [8]  %02X %02X %02X 00 00 00 00 00\n",
+             MESSAGE_2, throttle, controllerTemp, motorTemp);
+    data.append(line);
+
+    return data;
+}
+
+
+static QJsonObject benchPage(const char *name, Connections *connection, RenderScheduler *render,
+                             FrameProbe *probe, int rate, int duration)
+{
+    QElapsedTimer wall, timer;
+    qint64 period = 1000000000LL / rate;
+    qint64 decodeNs = 0, decodeMaxNs = 0;
+    int updates = 0;
+
+    runFor(SETTLE_TIME);
+    render->resetStats();
+    probe->reset();
+    std::clock_t cpu = std::clock();
+    wall.start();
+
+    while (wall.nsecsElapsed() < duration * 1000000000LL) {
+        timer.start();
+        connection->feed(frames(updates, rate));
+        qint64 ns = timer.nsecsElapsed();
+        decodeNs += ns;
+        decodeMaxNs = qMax(decodeMaxNs, ns);
+        updates++;
+
+        /* fixed rate - wait for next tick in event loop (render clock, paints) */
+        runFor((updates * period - wall.nsecsElapsed()) / 1000000);
+    }
+
+    double seconds = wall.nsecsElapsed() / 1e9;
+    double cpuMs = double(std::clock() - cpu) * 1000 / CLOCKS_PER_SEC;
+    const RenderStats &stats = render->getStats();
+    quint64 renderFrames = stats.frames - stats.idle;
+
+    QJsonObject page;
+    page["page"] = name;
+    page["seconds"] = seconds;
+    page["updates"] = updates;
+    page["update_us"] = updates ? decodeNs / 1000.0 / updates : 0;
+    page["update_max_us"] = decodeMaxNs / 1000.0;
+    page["render_frames"] = double(renderFrames);
+    page["render_us"] = renderFrames ? double(stats.totalCost) / renderFrames : 0;
+    page["render_max_us"] = double(stats.maxCost);
+    page["frames"] = double(probe->frames);
+    page["frames_per_s"] = probe->frames / seconds;
+    page["paint_us"] = probe->frames ? probe->paintNs / 1000.0 / probe->frames : 0;
+    page["paint_max_us"] = probe->paintMaxNs / 1000.0;
+    page["paint_events"] = double(probe->paints);
+    page["painted_kpx_per_s"] = probe->area / 1000.0 / seconds;
+    page["cpu_ms_per_s"] = cpuMs / seconds;
+
+    fprintf(stderr, "%-10s %6.1f fps  paint %8.1f us  %8.1f kpx/s  update %6.1f us  render %6.1f us  "
+            "cpu %6.1f ms/s\n", name, page["frames_per_s"].toDouble(), page["paint_us"].toDouble(),
+            page["painted_kpx_per_s"].toDouble(), page["update_us"].toDouble(),
+            page["render_us"].toDouble(), page["cpu_ms_per_s"].toDouble());
+
+    return page;
+}
+
+
+int main(int argc, char *argv[])
+{
+    int rate = DEFAULT_RATE;
+    int duration = DEFAULT_DURATION;
+    const char *output = NULL;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "hr:d:o:")) != -1) {
+        switch (opt) {
+        case 'r':
+            rate = qMax(1, atoi(optarg));
+            break;
+        case 'd':
+            duration = qMax(1, atoi(optarg));
+            break;
+        case 'o':
+            output = optarg;
+            break;
+        default:
+            fprintf(stderr, "Usage: %s [-r rate] [-d seconds] [-o file]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    QApplication app(argc, argv);
+    QElapsedTimer startup;
+    startup.start();
+    MainWindow window;
+    window.show();
+    app.processEvents();
+    double startupMs = startup.nsecsElapsed() / 1e6;
+    fprintf(stderr, "startup %.1f ms\n", startupMs);
+
+    Connections *connection = window.getConnection();
+    RenderScheduler *render = window.findChild<RenderScheduler *>();
+    QStackedWidget *pages = window.findChild<QStackedWidget *>("stackedWidget");
+    QPushButton *chartButton = window.findChild<QPushButton *>("currentChartBtn");
+    if (!connection || !render || !pages) {
+        fprintf(stderr, "dashboard widgets not found\n");
+        return 1;
+    }
+
+    FrameProbe probe(&window);
+    app.installEventFilter(&probe);
+
+    /* data is flowing - continuous targets (gauge, charts) are rendered */
+    emit connection->setConnectionStateButton(true);
+
+    static const char * const names[PAGES] = { "drive", "alerts", "stats", "settings" };
+    double painted[2][PAGES] = { { 0 } };
+    QJsonArray runs;
+
+    for (int partial = 0; partial < 2; ++partial) {
+        fprintf(stderr, "%s repaint\n", partial ? "partial" : "full");
+        window.setPartialRepaint(partial);
+
+        QJsonArray results;
+        for (int i = 0; i < pages->count() && i < PAGES; ++i) {
+            pages->setCurrentIndex(i);
+            if (i == PAGE_STATS && chartButton)
+                chartButton->click();
+            QJsonObject page = benchPage(names[i], connection, render, &probe, rate, duration);
+            painted[partial][i] = page["painted_kpx_per_s"].toDouble();
+            results.append(page);
+        }
+
+        QJsonObject run;
+        run["partial_repaint"] = bool(partial);
+        run["pages"] = results;
+        runs.append(run);
+    }
+
+    /* partial repaint must not paint more than full repaint */
+    QJsonObject reduction;
+    for (int i = 0; i < pages->count() && i < PAGES; ++i) {
+        double ratio = painted[0][i] > 0 ? 1 - painted[1][i] / painted[0][i] : 0;
+        reduction[names[i]] = ratio;
+        fprintf(stderr, "%-10s painted area reduction %5.1f %%%s\n", names[i], 100 * ratio,
+                ratio < 0 ? " - REGRESSION" : "");
+    }
+
+    emit connection->setConnectionStateButton(false);
+    app.removeEventFilter(&probe);
+
+    QJsonObject root;
+    root["benchmark"] = "pages";
+    root["qt"] = qVersion();
+    root["platform"] = QGuiApplication::platformName();
+    root["cpu"] = QSysInfo::currentCpuArchitecture();
+    root["os"] = QSysInfo::prettyProductName();
+    root["host"] = QSysInfo::machineHostName();
+    root["rate_hz"] = rate;
+    root["duration_s"] = duration;
+    root["startup_ms"] = startupMs;
+    root["runs"] = runs;
+    root["painted_area_reduction"] = reduction;
+
+    QByteArray json = QJsonDocument(root).toJson(QJsonDocument::Indented);
+    if (output) {
+        QFile file(output);
+        if (!file.open(QIODevice::WriteOnly)) {
+            fprintf(stderr, "cannot write %s\n", output);
+            return 1;
+        }
+        file.write(json);
+    } else {
+        fwrite(json.constData(), 1, json.size(), stdout);
+    }
+
+    return 0;
+}
@@ -0,0 +1,233 @@
+/*
+ * Offscreen benchmark of rpm indicator updates.
+ *
+ * Compares cost of one update of the old indicator (scene cleared and
+ * rebuilt with new items, pens and brushes on every sample) with the
+ * current RpmWidget (single painted gauge, dirty region repaint). Every
+ * update is followed by event processing, so the cost includes repaint.
+ *
+ * Alert leds are measured as one row of 12 leds toggled by alert
+ * pattern, with paint time and hit rate of the shared led pixmap cache.
+ *
+ * Panel displays are measured as 6 three digit displays updated with new
+ * values and repainted, QLCDNumber against SegmentDisplay (glyph atlas).
+ *
+ * Usage: QT_QPA_PLATFORM=offscreen bin/vocc_bench [updates]
+ */
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QGraphicsView>
+#include <QGraphicsScene>
+#include <QGraphicsEllipseItem>
+#include <QGraphicsLineItem>
+#include <QtMath>
+#include <QLCDNumber>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../src/main/rpmwidget.h"
+#include "../src/alerts/ledindicator.h"
+#include "../src/main/segmentdisplay.h"
+#include "../src/common/logger.h"
+#include "../src/common/parameters.h"
+#include "../src/common/pipeline.h"
+
+#define DEFAULT_UPDATES     2000
+#define VIEW_WIDTH          301
+#define VIEW_HEIGHT         270
+#define LED_COUNT           12
+#define LED_SIZE            22
+#define PANEL_DISPLAYS      6
+#define PANEL_WIDTH         121
+#define PANEL_HEIGHT        111
+
+int gLogMask = 0;
+StageCounter gStages[STAGE_COUNT];
+
+void logger (int level, bool raw, const char *fmt, ...)
+{
+    Q_UNUSED(level);
+    Q_UNUSED(raw);
+    Q_UNUSED(fmt);
+}
+
+
+/* indicator as drawn before retained items (RpmWidget::drawLine) */
+static void legacyDrawLine(QGraphicsView *view, QGraphicsScene *scene, int value)
+{
+    double x1, x2, y1, y2, lineLength, angle, angleOffset;
+
+    QGraphicsEllipseItem *pintopItem;
+    QGraphicsLineItem *lineItem;
+    scene->clear();
+
+    QColor color(0,0,0);
+    color.setNamedColor("#22e2a2");
+    QBrush brush(color);
+    QPen pen(brush, 5, Qt::SolidLine, Qt::RoundCap);
+    QPen penPintop(brush, 10, Qt::SolidLine, Qt::RoundCap);
+
+    x1 = view->width()/2;
+    y1 = view->height()/2;
+
+    lineLength = (view->width()/2) - 10.0;
+    angle = (qDegreesToRadians(ANGLE_RANGE) * value)/MAX_RPM_VALUE;
+    angleOffset = (360 - ANGLE_RANGE)/2;
+
+    x2 = lineLength * qSin(angle + qDegreesToRadians(angleOffset));
+    y2 = (-1) * lineLength * qCos(angle + qDegreesToRadians(angleOffset));
+
+    QRectF pintop(x1 - 2, y1 - 4, 10, 10);
+    pintopItem = new QGraphicsEllipseItem(pintop);
+    scene->addItem(pintopItem);
+    pintopItem->setPen(penPintop);
+
+    QLineF line(x1, y1, x1 - x2, y1 - y2 + 10);
+    lineItem = new QGraphicsLineItem(line);
+    scene->addItem(lineItem);
+    lineItem->setPen(pen);
+}
+
+
+/* rpm samples - slow sweep with noise, like CAN data during acceleration */
+static int sample(int i)
+{
+    return qBound(0, (i * 7) % MAX_RPM_VALUE + (rand() % 200) - 100, MAX_RPM_VALUE);
+}
+
+
+static double benchLegacy(int updates)
+{
+    QGraphicsView view;
+    QGraphicsScene scene;
+    QElapsedTimer timer;
+
+    view.resize(VIEW_WIDTH, VIEW_HEIGHT);
+    view.setScene(&scene);
+    view.setSceneRect(0, 0, VIEW_WIDTH, VIEW_HEIGHT);
+    view.setRenderHint(QPainter::Antialiasing, true);
+    view.show();
+    QApplication::processEvents();
+
+    srand(1);
+    timer.start();
+    for (int i = 0; i < updates; ++i) {
+        legacyDrawLine(&view, &scene, sample(i));
+        QApplication::processEvents();
+    }
+
+    return timer.nsecsElapsed() / 1000.0 / updates;
+}
+
+
+static double benchWidget(int updates)
+{
+    RpmWidget widget;
+    QElapsedTimer timer;
+
+    widget.show();
+    QApplication::processEvents();
+
+    srand(1);
+    timer.start();
+    for (int i = 0; i < updates; ++i) {
+        widget.updateWidget(sample(i));
+        QApplication::processEvents();
+    }
+
+    return timer.nsecsElapsed() / 1000.0 / updates;
+}
+
+
+static double benchLeds(int updates)
+{
+    QWidget panel;
+    LedIndicator *leds[LED_COUNT];
+    QElapsedTimer timer;
+
+    panel.resize(LED_COUNT * LED_SIZE, LED_SIZE);
+    for (int i = 0; i < LED_COUNT; ++i) {
+        leds[i] = new LedIndicator(&panel);
+        leds[i]->setGeometry(i * LED_SIZE, 0, LED_SIZE, LED_SIZE);
+    }
+    panel.show();
+    QApplication::processEvents();
+    LedIndicator::resetCacheStats();
+
+    srand(1);
+    timer.start();
+    for (int i = 0; i < updates; ++i) {
+        int mask = rand();
+        for (int j = 0; j < LED_COUNT; ++j)
+            leds[j]->setChecked(mask & (1 << j));
+        panel.repaint();
+    }
+
+    return timer.nsecsElapsed() / 1000.0 / updates;
+}
+
+
+/* panel values - slowly changing, like current and temperatures */
+template <typename T> static double benchPanel(int updates)
+{
+    QWidget panel;
+    T *displays[PANEL_DISPLAYS];
+    QElapsedTimer timer;
+
+    panel.resize(PANEL_DISPLAYS * PANEL_WIDTH, PANEL_HEIGHT);
+    for (int i = 0; i < PANEL_DISPLAYS; ++i) {
+        displays[i] = new T(&panel);
+        displays[i]->setDigitCount(3);
+        displays[i]->setGeometry(i * PANEL_WIDTH, 0, PANEL_WIDTH, PANEL_HEIGHT);
+    }
+    panel.show();
+    QApplication::processEvents();
+
+    srand(1);
+    timer.start();
+    for (int i = 0; i < updates; ++i) {
+        for (int j = 0; j < PANEL_DISPLAYS; ++j)
+            displays[j]->display(double(100 + (i / (j + 1)) % 50 + rand() % 3));
+        QApplication::processEvents();
+    }
+
+    return timer.nsecsElapsed() / 1000.0 / updates;
+}
+
+
+int main(int argc, char *argv[])
+{
+    if (qgetenv("QT_QPA_PLATFORM").isEmpty())
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    QApplication a(argc, argv);
+    int updates = (argc > 1) ? atoi(argv[1]) : DEFAULT_UPDATES;
+    if (updates <= 0)
+        updates = DEFAULT_UPDATES;
+
+    double legacy = benchLegacy(updates);
+    double current = benchWidget(updates);
+    double leds = benchLeds(updates);
+    quint64 hits = LedIndicator::getCacheHits();
+    quint64 misses = LedIndicator::getCacheMisses();
+    double lcd = benchPanel<QLCDNumber>(updates);
+    SegmentDisplay::resetCacheStats();
+    double segment = benchPanel<SegmentDisplay>(updates);
+    quint64 glyphHits = SegmentDisplay::getCacheHits();
+    quint64 glyphMisses = SegmentDisplay::getCacheMisses();
+
+    printf("rpm indicator, %d updates\n", updates);
+    printf("  scene rebuild (old)     %8.1f us/update (needle only)\n", legacy);
+    printf("  RpmWidget               %8.1f us/update (needle, dots, LCD)\n", current);
+    printf("alert leds, %d updates\n", updates);
+    printf("  %d leds repaint         %8.1f us/update, cache hit rate %.2f %% (%llu hits, %llu misses)\n",
+           LED_COUNT, leds, (hits + misses) ? 100.0 * hits / (hits + misses) : 0.0,
+           (unsigned long long)hits, (unsigned long long)misses);
+    printf("panel displays, %d updates\n", updates);
+    printf("  QLCDNumber              %8.1f us/update (%d displays)\n", lcd, PANEL_DISPLAYS);
+    printf("  SegmentDisplay          %8.1f us/update, atlas hit rate %.2f %% (%llu hits, %llu misses)\n",
+           segment, (glyphHits + glyphMisses) ? 100.0 * glyphHits / (glyphHits + glyphMisses) : 0.0,
+           (unsigned long long)glyphHits, (unsigned long long)glyphMisses);
+
+    return 0;
+}
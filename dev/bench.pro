@@ -0,0 +1,50 @@
+#-------------------------------------------------
+#
+# Offscreen benchmarks of dashboard widgets
+#
+#-------------------------------------------------
+
+QMAKE_CXXFLAGS_RELEASE += -O2
+
+
+QT       += core gui
+
+greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
+
+TARGET = vocc_bench
+TEMPLATE = app
+
+CONFIG += c++11
+
+# promoted widgets of ui files
+INCLUDEPATH += $$PWD/../src/main
+
+DESTDIR = ../bin
+
+OBJECTS_DIR = obj_bench/
+
+MOC_DIR = moc_bench/
+
+SOURCES += \
+    ../bench/rpm_bench.cpp \
+    ../src/main/rpmwidget.cpp \
+    ../src/main/rpmgauge.cpp \
+    ../src/main/segmentdisplay.cpp \
+    ../src/alerts/ledindicator.cpp
+
+
+HEADERS  += \
+    ../src/main/rpmwidget.h \
+    ../src/main/rpmgauge.h \
+    ../src/main/segmentdisplay.h \
+    ../src/alerts/ledindicator.h \
+    ../src/common/logger.h \
+    ../src/common/parameters.h \
+    ../src/common/pipeline.h
+
+
+FORMS += \
+    ../ui/rpmwidget.ui
+
+RESOURCES += \
+    ../img/img.qrc
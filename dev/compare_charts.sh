@@ -0,0 +1,58 @@
+#!/bin/sh
+#
+# Compares QtCharts statistics charts (revision before StripChart) with
+# a newer revision: startup time, binary size (size of bin/vocc) and
+# per-frame cost of the stats page of the page benchmark (full repaint).
+#
+# Both revisions are built in temporary git worktrees with qmake, the old
+# one gets page benchmark of the new one (startup time is measured since
+# StripChart). JSON results are kept in the printed directory.
+#
+# Usage: dev/compare_charts.sh [old revision] [new revision] [seconds per page]
+#
+set -e
+
+OLD=${1:-c0b281f^}
+NEW=${2:-HEAD}
+DURATION=${3:-5}
+ROOT=$(git rev-parse --show-toplevel)
+WORK=$(mktemp -d)
+JOBS=$(nproc 2>/dev/null || echo 2)
+
+cleanup() {
+    git -C "$ROOT" worktree remove --force "$WORK/old" 2>/dev/null || true
+    git -C "$ROOT" worktree remove --force "$WORK/new" 2>/dev/null || true
+}
+trap cleanup EXIT
+
+git -C "$ROOT" worktree add --detach "$WORK/old" "$OLD" >/dev/null
+git -C "$ROOT" worktree add --detach "$WORK/new" "$NEW" >/dev/null
+git -C "$ROOT" show "$NEW:bench/page_bench.cpp" > "$WORK/old/bench/page_bench.cpp"
+
+for tree in old new; do
+    echo "building $tree" >&2
+    (cd "$WORK/$tree/dev" &&
+        qmake -o Makefile.vocc vocc.pro && make -f Makefile.vocc -j"$JOBS" &&
+        qmake -o Makefile.page_bench page_bench.pro && make -f Makefile.page_bench -j"$JOBS") \
+        > "$WORK/$tree.log" 2>&1 || { echo "build of $tree failed, see $WORK/$tree.log" >&2; exit 1; }
+
+    echo "running $tree" >&2
+    (cd "$WORK/$tree/bin" && QT_QPA_PLATFORM=offscreen ./vocc_page_bench -d "$DURATION" -o "$WORK/$tree.json")
+    size "$WORK/$tree/bin/vocc" > "$WORK/$tree.size"
+done
+
+python3 - "$WORK" "$OLD" "$NEW" <<'EOF'
+import json, sys
+
+work, names = sys.argv[1], { "old": sys.argv[2], "new": sys.argv[3] }
+print("%-8s %-12s %10s %10s %10s %12s %10s" % ("build", "revision", "startup ms", "text B", "total B",
+                                               "stats pnt us", "stats cpu"))
+for tree in ("old", "new"):
+    result = json.load(open("%s/%s.json" % (work, tree)))
+    size = open("%s/%s.size" % (work, tree)).read().split("\n")[1].split()
+    stats = [p for p in result["runs"][0]["pages"] if p["page"] == "stats"][0]
+    print("%-8s %-12s %10.1f %10s %10s %12.1f %10.1f" % (tree, names[tree], result["startup_ms"], size[0], size[3],
+                                                         stats["paint_us"], stats["cpu_ms_per_s"]))
+EOF
+
+echo "results in $WORK" >&2
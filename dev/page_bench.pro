@@ -0,0 +1,103 @@
+#-------------------------------------------------
+#
+# Offscreen benchmark of dashboard pages
+#
+#-------------------------------------------------
+
+QMAKE_CXXFLAGS_RELEASE += -O2
+
+
+QT       += core gui network
+
+greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
+
+DEFINES += GIT_VERSION="\\\"$(shell git -C \""$$_PRO_FILE_PWD_"\" describe --tags --abbrev=0)\\\""
+
+TARGET = vocc_page_bench
+TEMPLATE = app
+
+INCLUDEPATH += $$PWD/../libs/include
+DEPENDPATH += $$PWD/../libs/include
+
+# promoted widgets of ui files
+INCLUDEPATH += $$PWD/../src/main
+
+CONFIG += c++11
+
+DESTDIR = ../bin
+
+OBJECTS_DIR = obj_page_bench/
+
+MOC_DIR = moc_page_bench/
+
+SOURCES += \
+    ../bench/page_bench.cpp \
+    ../src/alerts/ledindicator.cpp \
+    ../src/alerts/alerts.cpp \
+    ../src/alerts/batterywidget.cpp \
+    ../src/alerts/controllerwidget.cpp \
+    ../src/settings/settings.cpp \
+    ../src/connections/connections.cpp \
+    ../src/connections/expression.cpp \
+    ../src/connections/capture.cpp \
+    ../src/connections/history.cpp \
+    ../src/connections/distribution.cpp \
+    ../src/main/mainwindow.cpp \
+    ../src/main/rpmwidget.cpp \
+    ../src/main/rpmgauge.cpp \
+    ../src/main/overload.cpp \
+    ../src/main/renderscheduler.cpp \
+    ../src/main/threshold.cpp \
+    ../src/main/theme.cpp \
+    ../src/main/segmentdisplay.cpp \
+    ../src/main/perfoverlay.cpp \
+    ../src/stats/statistics.cpp \
+    ../src/settings/parser.c \
+    ../src/settings/progressIndicator.cpp \
+    ../src/stats/stripchart.cpp \
+    ../src/stats/distributionchart.cpp
+
+
+HEADERS  += \
+    ../src/alerts/ledindicator.h \
+    ../src/alerts/alerts.h \
+    ../src/alerts/batterywidget.h \
+    ../src/alerts/controllerwidget.h \
+    ../src/settings/settings.h \
+    ../src/common/logger.h \
+    ../src/common/parameters.h \
+    ../src/common/telemetry.h \
+    ../src/common/limits.h \
+    ../src/common/pipeline.h \
+    ../src/connections/connections.h \
+    ../src/connections/expression.h \
+    ../src/connections/capture.h \
+    ../src/connections/history.h \
+    ../src/connections/distribution.h \
+    ../src/connections/lanes.h \
+    ../src/main/mainwindow.h \
+    ../src/main/rpmwidget.h \
+    ../src/main/rpmgauge.h \
+    ../src/main/overload.h \
+    ../src/main/renderscheduler.h \
+    ../src/main/threshold.h \
+    ../src/main/theme.h \
+    ../src/main/segmentdisplay.h \
+    ../src/main/perfoverlay.h \
+    ../src/stats/statistics.h \
+    ../src/settings/parser.h \
+    ../src/settings/progressIndicator.h \
+    ../src/stats/stripchart.h \
+    ../src/stats/distributionchart.h
+
+
+FORMS += \
+    ../ui/mainwindow.ui \
+    ../ui/rpmwidget.ui \
+    ../ui/controllerwidget.ui \
+    ../ui/batterywidget.ui \
+    ../ui/settings.ui \
+    ../ui/statistics.ui
+
+RESOURCES += \
+    ../img/img.qrc
@@ -17,11 +17,13 @@ TARGET = vocc
 TEMPLATE = app
 
 #QMAKE_LFLAGS += -static
-#unix:!macx: LIBS += -L$$PWD/../libs/ -lQt5Charts
 
 INCLUDEPATH += $$PWD/../libs/include
 DEPENDPATH += $$PWD/../libs/include
 
+# promoted widgets of ui files
+INCLUDEPATH += $$PWD/../src/main
+
 CONFIG += c++11
 
 DESTDIR = ../bin
@@ -38,12 +40,24 @@ SOURCES += \
     ../src/alerts/controllerwidget.cpp \
     ../src/settings/settings.cpp \
     ../src/connections/connections.cpp \
+    ../src/connections/expression.cpp \
+    ../src/connections/capture.cpp \
+    ../src/connections/history.cpp \
+    ../src/connections/distribution.cpp \
     ../src/main/mainwindow.cpp \
     ../src/main/rpmwidget.cpp \
+    ../src/main/rpmgauge.cpp \
+    ../src/main/overload.cpp \
+    ../src/main/renderscheduler.cpp \
+    ../src/main/threshold.cpp \
+    ../src/main/theme.cpp \
+    ../src/main/segmentdisplay.cpp \
+    ../src/main/perfoverlay.cpp \
     ../src/stats/statistics.cpp \
     ../src/settings/parser.c \
     ../src/settings/progressIndicator.cpp \
-    ../src/stats/chart.cpp
+    ../src/stats/stripchart.cpp \
+    ../src/stats/distributionchart.cpp
 
 
 HEADERS  += \
@@ -54,13 +68,29 @@ HEADERS  += \
     ../src/settings/settings.h \
     ../src/common/logger.h \
     ../src/common/parameters.h \
+    ../src/common/telemetry.h \
+    ../src/common/limits.h \
+    ../src/common/pipeline.h \
     ../src/connections/connections.h \
+    ../src/connections/expression.h \
+    ../src/connections/capture.h \
+    ../src/connections/history.h \
+    ../src/connections/distribution.h \
+    ../src/connections/lanes.h \
     ../src/main/mainwindow.h \
     ../src/main/rpmwidget.h \
+    ../src/main/rpmgauge.h \
+    ../src/main/overload.h \
+    ../src/main/renderscheduler.h \
+    ../src/main/threshold.h \
+    ../src/main/theme.h \
+    ../src/main/segmentdisplay.h \
+    ../src/main/perfoverlay.h \
     ../src/stats/statistics.h \
     ../src/settings/parser.h \
     ../src/settings/progressIndicator.h \
-    ../src/stats/chart.h
+    ../src/stats/stripchart.h \
+    ../src/stats/distributionchart.h
 
 
 FORMS += \
@@ -73,14 +103,3 @@ FORMS += \
 
 RESOURCES += \
     ../img/img.qrc
-
-SUBDIRS += \
-    ../src/qt/chartviewer.pro
-
-
-unix:!macx: LIBS += -L$$PWD/../libs -lQt5Charts
-
-INCLUDEPATH += $$PWD/../libs/include/QtCharts
-DEPENDPATH += $$PWD/../libs/include/QtCharts
-
-unix:!macx: PRE_TARGETDEPS += $$PWD/../libs/libQt5Charts.a
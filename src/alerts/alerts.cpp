@@ -1,4 +1,5 @@
 #include <QLabel>
+#include <QtAlgorithms>
 #include "alerts.h"
 #include "../common/logger.h"
 
@@ -13,6 +14,18 @@ Alerts::Alerts(QWidget *controllerWidget, QWidget *batteryWidget)
 
     initWidget(controllerWidget);
     initWidget(batteryWidget);
+
+    /* map alert bits to leds once, reserved bits have no led */
+    validMask = 0;
+    for (int i = 0, it = 0; i < 16; ++i) {
+        ledIndex[i] = -1;
+        if (con->controllerErrors[i] != "RESERVED") {
+            validMask |= 1 << i;
+            ledIndex[i] = it++;
+        }
+    }
+    shownMask = 0;
+    shownValid = false;
 }
 
 
@@ -71,31 +84,30 @@ void Alerts::initWidget(QWidget *widget)
 }
 
 
-void Alerts::updateAlertsState(char alerts[16])
+void Alerts::updateAlertsState(quint16 mask)
 {
-    int it = 0, n_err = 0;
-
-    for (int i = 0; i < 16; ++i) {
-        if (con->controllerErrors[i] != "RESERVED") {
-            if (alerts[i] == '0') { /* found errors */
-                controllerLeds.at(it)->setCheckable(true);
-                controllerLeds.at(it)->setChecked(false);
-                controllerLeds.at(it)->setDown(false);
-                batteryLeds.at(it)->setCheckable(true);
-                batteryLeds.at(it)->setChecked(false);
-                batteryLeds.at(it)->setDown(false);
-                n_err++;
-            } else { /* did not found errors */
-                controllerLeds.at(it)->setCheckable(true);
-                controllerLeds.at(it)->setChecked(true);
-                controllerLeds.at(it)->setDown(true);
-                batteryLeds.at(it)->setCheckable(true);
-                batteryLeds.at(it)->setChecked(true);
-                batteryLeds.at(it)->setDown(true);
-            }
-            it++;
+    mask &= validMask;
+
+    /* touch only leds whose alert bit changed (all leds on first update) */
+    quint16 changed = shownValid ? (mask ^ shownMask) : validMask;
+    for (quint16 bits = changed; bits; bits &= bits - 1) {
+        int i = qCountTrailingZeroBits(bits);
+        bool alert = mask & (1 << i);
+
+        /* led is green when checked, red when alert is active */
+        if (ledIndex[i] < controllerLeds.size()) {
+            controllerLeds.at(ledIndex[i])->setCheckable(true);
+            controllerLeds.at(ledIndex[i])->setChecked(!alert);
+        }
+        if (ledIndex[i] < batteryLeds.size()) {
+            batteryLeds.at(ledIndex[i])->setCheckable(true);
+            batteryLeds.at(ledIndex[i])->setChecked(!alert);
         }
     }
+    shownMask = mask;
+    shownValid = true;
+
+    int n_err = qPopulationCount(mask);
     emit setAlertsButtonState(n_err);
 
     if (n_err > 0)
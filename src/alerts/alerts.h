@@ -43,9 +43,9 @@ public:
 public slots:
     /**
      * @brief updateAlertsState - method that receives data about alerts
-     * @param alerts - is a char array
+     * @param mask - alert bits (bit set - alert active)
      */
-    void updateAlertsState(char alerts[16]);
+    void updateAlertsState(quint16 mask);
 
 signals:
     /**
@@ -59,6 +59,10 @@ private:
     LedIndicator *led; /// - is a pointer of LedIndicator object
     QList<QFrame *> ledSlots; /// - is a QList object keeping pointers of QFrame objects
     QList<LedIndicator *> controllerLeds, batteryLeds; /// - are a QLists objects keeping pointers of LedIndicator objects
+    quint16 validMask; /// - alert bits which have led (not reserved)
+    quint16 shownMask; /// - alert bits shown by leds
+    bool shownValid; /// - keeps information whether leds show shownMask
+    int ledIndex[16]; /// - led of alert bit
 
 protected:
     /**
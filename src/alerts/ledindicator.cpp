@@ -2,13 +2,35 @@
 #include <QtGlobal>
 #include <QPen>
 #include <QPainter>
+#include <QPaintEvent>
 #include <QRadialGradient>
 #include <QPointF>
 #include <QBrush>
+#include <QtMath>
+#include <QCoreApplication>
 #include "ledindicator.h"
 #include "../common/logger.h"
 
 #define CLASS_INFO          "led"
+#define SCALED_SIZE         600.0
+
+/* defining green color of led */
+static const QColor onColor1(153, 255, 153);
+static const QColor onColor2(153, 255, 153);
+
+/* defining red color of led */
+static const QColor offColor1(255, 77, 77);
+static const QColor offColor2(255, 49, 49);
+
+QHash<quint64, QPixmap> LedIndicator::sCache;
+quint64 LedIndicator::sHits = 0;
+quint64 LedIndicator::sMisses = 0;
+
+/* pixmaps must be released before application object */
+static void releaseCache(void)
+{
+    LedIndicator::clearCache();
+}
 
 LedIndicator::LedIndicator(QWidget *parent)
     : QAbstractButton(parent)
@@ -16,18 +38,10 @@ LedIndicator::LedIndicator(QWidget *parent)
 
     LOG (LOG_LEDINDICATOR, "%s - in contructor", CLASS_INFO);
 
-    scaledSize = 600;
+    mPartial = false;
     this->setMinimumSize(22, 22);
     this->setCheckable(true);
     this->setStyleSheet("border: 1px solid red");
-
-    /* defining green color of led */
-    onColor1 = QColor(153, 255, 153);
-    onColor2 = QColor(153, 255, 153);
-
-    /* defining red color of led */
-    offColor1 = QColor(255, 77, 77);
-    offColor2 = QColor(255, 49, 49);
 }
 
 LedIndicator::~LedIndicator()
@@ -43,41 +57,104 @@ void LedIndicator::resizeEvent(QResizeEvent *)
 }
 
 
-void LedIndicator::paintEvent(QPaintEvent *)
+void LedIndicator::setPartialRepaint(bool enable)
 {
-    LOG (LOG_LEDINDICATOR, "%s - %s", CLASS_INFO, Q_FUNC_INFO);
+    mPartial = enable;
+    updateOpaque();
+    this->update();
+}
 
-    int realSize;
 
-    realSize = qMin(this->width(), this->height());
+void LedIndicator::updateOpaque(void)
+{
+    setAttribute(Qt::WA_OpaquePaintEvent, mPartial && palette().brush(backgroundRole()).isOpaque());
+}
+
+
+void LedIndicator::changeEvent(QEvent *event)
+{
+    if (event->type() == QEvent::PaletteChange)
+        updateOpaque();
+
+    QAbstractButton::changeEvent(event);
+}
+
+
+void LedIndicator::paintEvent(QPaintEvent *event)
+{
+    int realSize = qMin(this->width(), this->height());
+    if (realSize <= 0)
+        return;
 
     QPainter painter(this);
+    /* corners around round led are background */
+    if (testAttribute(Qt::WA_OpaquePaintEvent))
+        painter.fillRect(event->rect(), palette().brush(backgroundRole()));
+    painter.drawPixmap((this->width() - realSize) / 2, (this->height() - realSize) / 2,
+                       pixmap(this->isChecked(), realSize, this->devicePixelRatioF()));
+}
+
+
+const QPixmap &LedIndicator::pixmap(bool on, int size, qreal ratio)
+{
+    quint64 key = (quint64(qRound(ratio * 100)) << 33) | (quint64(size) << 1) | on;
+
+    QHash<quint64, QPixmap>::const_iterator it = sCache.constFind(key);
+    if (it != sCache.constEnd()) {
+        sHits++;
+        return it.value();
+    }
+
+    LOG (LOG_LEDINDICATOR, "%s - rendering %s led %d px (ratio %.2f)", CLASS_INFO,
+         on ? "on" : "off", size, ratio);
+    if (sCache.isEmpty())
+        qAddPostRoutine(releaseCache);
+    sMisses++;
+
+    QPixmap image(qCeil(size * ratio), qCeil(size * ratio));
+    image.setDevicePixelRatio(ratio);
+    image.fill(Qt::transparent);
+
+    QPainter painter(&image);
     QPen pen(Qt::black);
     pen.setWidth(1);
 
     painter.setRenderHint(QPainter::Antialiasing);
-    painter.translate(this->width()/2 , this->height()/2);
-    painter.scale(realSize / scaledSize, realSize / scaledSize);
+    painter.translate(size / 2.0, size / 2.0);
+    painter.scale(size / SCALED_SIZE, size / SCALED_SIZE);
 
     QRadialGradient gradient(QPointF(-450, -450), 1500, QPointF(-450, -450));
-//    gradient.setColorAt(0, QColor(245, 245, 245));
-//    gradient.setColorAt(1, QColor(120, 120, 120));
-
-//    painter.setPen(pen);
-//    painter.setBrush(QBrush(gradient));
-//    painter.drawEllipse(QPointF(0, 0), 310, 310);
+    gradient.setColorAt(0, on ? onColor1 : offColor1);
+    gradient.setColorAt(1, on ? onColor2 : offColor2);
 
     painter.setPen(pen);
-    if (this->isChecked()) {
-        LOG (LOG_LEDINDICATOR, "%s - %s - gradient on", CLASS_INFO, Q_FUNC_INFO);
-        gradient.setColorAt(0, this->onColor1);
-        gradient.setColorAt(1, this->onColor2);
-    } else {
-        LOG (LOG_LEDINDICATOR, "%s - %s - gradient off", CLASS_INFO, Q_FUNC_INFO);
-        gradient.setColorAt(0, this->offColor1);
-        gradient.setColorAt(1, this->offColor2);
-    }
-
     painter.setBrush(QBrush(gradient));
     painter.drawEllipse(QPointF(0, 0), 250, 250);
+    painter.end();
+
+    return sCache.insert(key, image).value();
+}
+
+
+quint64 LedIndicator::getCacheHits(void)
+{
+    return sHits;
+}
+
+
+quint64 LedIndicator::getCacheMisses(void)
+{
+    return sMisses;
+}
+
+
+void LedIndicator::resetCacheStats(void)
+{
+    sHits = sMisses = 0;
+}
+
+
+void LedIndicator::clearCache(void)
+{
+    sCache.clear();
 }
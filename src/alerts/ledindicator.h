@@ -3,7 +3,9 @@
  *
  * \brief
  *
- * This class is used to draw led indicator
+ * This class is used to draw led indicator. Led images are rendered once
+ * to a process-wide pixmap cache keyed by state, size and device pixel
+ * ratio, so a repaint is a single drawPixmap.
  *
  * \author Karol Siegieda
  *
@@ -20,6 +22,8 @@
 #include <QColor>
 #include <QWidget>
 #include <QFrame>
+#include <QHash>
+#include <QPixmap>
 
 class LedIndicator : public QAbstractButton
 {
@@ -32,10 +36,31 @@ public:
     explicit LedIndicator(QWidget *parent);
     ~LedIndicator();
 
+    /// returns number of paints served from cache and number of rendered images
+    static quint64 getCacheHits(void);
+    static quint64 getCacheMisses(void);
+    /// resets cache counters
+    static void resetCacheStats(void);
+    /// releases cached led images
+    static void clearCache(void);
+    /// enables/disables partial repaint mode (led paints its background and is opaque)
+    void setPartialRepaint(bool enable);
+
 private:
-    QColor offColor1, offColor2;
-    QColor onColor1, onColor2;
-    float scaledSize;
+    /**
+     * @brief pixmap - returns cached led image, renders it on first use
+     * @param on - led state
+     * @param size - led diameter [px]
+     * @param ratio - device pixel ratio
+     */
+    static const QPixmap &pixmap(bool on, int size, qreal ratio);
+
+    /// led is opaque in partial repaint mode if its background is opaque
+    void updateOpaque(void);
+
+    bool mPartial; /// - partial repaint mode
+    static QHash<quint64, QPixmap> sCache; /// - led images of all widgets
+    static quint64 sHits, sMisses; /// - cache counters
 
 protected:
     /**
@@ -46,6 +71,10 @@ protected:
      * @brief paintEvent - reimplemented method called when request to repaint a widget occured
      */
     void paintEvent(QPaintEvent *);
+    /**
+     * @brief changeEvent - reimplemented method, background can become translucent
+     */
+    void changeEvent(QEvent *event);
 };
 
 #endif // LEDINDICATOR_H
@@ -0,0 +1,32 @@
+#ifndef LIMITS
+#define LIMITS
+
+#include "telemetry.h"
+
+/* warning and alarm limits of a channel, shared by displayed warnings (Threshold)
+ * and time beyond warning limit (Distribution):
+ *  rising  - warning < alarm, for example temperature
+ *  falling - warning > alarm, for example voltage
+ *  0/0     - disabled
+ */
+struct ThresholdLimits {
+    float warning; /// - warning limit
+    float alarm; /// - alarm limit
+    float hysteresis; /// - distance from limit needed to leave level
+
+    bool isEnabled(void) const { return warning != 0 || alarm != 0; }
+    bool isFalling(void) const { return alarm < warning; }
+};
+
+/* default limits of channels (settings.conf, "Limits" section) */
+static const ThresholdLimits defaultLimits[CHANNEL_COUNT] = {
+    { 0, 0, 0 },        /* rpm */
+    { 80, 140, 5 },     /* current [A] */
+    { 84, 74, 1 },      /* voltage [V] */
+    { 8, 20, 1 },       /* power [kW] */
+    { 0, 0, 0 },        /* throttle */
+    { 45, 65, 2 },      /* controller temperature [C] */
+    { 50, 65, 2 }       /* motor temperature [C] */
+};
+
+#endif // LIMITS
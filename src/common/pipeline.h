@@ -0,0 +1,44 @@
+#ifndef PIPELINE
+#define PIPELINE
+
+#include <QtGlobal>
+
+/* stages of data pipeline with change detection:
+ *  STAGE_FRAMES  - CAN frames, identical payloads are not decoded
+ *  STAGE_EMIT    - decoded values, changes inside dead-band are not emitted
+ *  STAGE_RENDER  - widget updates, unchanged displayed values are not repainted
+ */
+enum PipelineStage {
+    STAGE_FRAMES = 0,
+    STAGE_EMIT,
+    STAGE_RENDER,
+    STAGE_COUNT
+};
+
+static const char * const stageNames[STAGE_COUNT] = {
+    "frames",
+    "emit",
+    "render"
+};
+
+struct StageCounter {
+    quint64 processed; /// - number of done work items
+    quint64 skipped; /// - number of items skipped because nothing changed
+
+    void reset(void) { processed = skipped = 0; }
+};
+
+extern StageCounter gStages[STAGE_COUNT];
+
+/* counts work item of stage, returns changed (convenient in conditions) */
+inline bool stageCount(int stage, bool changed)
+{
+    if (changed)
+        gStages[stage].processed++;
+    else
+        gStages[stage].skipped++;
+
+    return changed;
+}
+
+#endif // PIPELINE
@@ -0,0 +1,27 @@
+#ifndef TELEMETRY
+#define TELEMETRY
+
+/* decoded signals, indexes are shared by every consumer of decoded data */
+enum TelemetryChannel {
+    CHANNEL_RPM = 0,
+    CHANNEL_CURRENT,
+    CHANNEL_VOLTAGE,
+    CHANNEL_POWER,
+    CHANNEL_THROTTLE,
+    CHANNEL_CONTR_TEMP,
+    CHANNEL_MOTOR_TEMP,
+    CHANNEL_COUNT
+};
+
+/* names used by computed channels expressions (settings.conf) */
+static const char * const channelNames[CHANNEL_COUNT] = {
+    "rpm",
+    "current",
+    "voltage",
+    "power",
+    "throttle",
+    "controller_temp",
+    "motor_temp"
+};
+
+#endif // TELEMETRY
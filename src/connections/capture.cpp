@@ -0,0 +1,380 @@
+#include <QDir>
+#include <QFile>
+#include <QTextStream>
+#include <QtMath>
+#include "capture.h"
+#include "../common/logger.h"
+
+#define CLASS_INFO          "capture"
+#define US_PER_SEC          1000000.0
+
+
+Capture::Capture(QObject *parent)
+    : QObject(parent)
+{
+    LOG (LOG_CONNECTIONS, "%s - in constructor", CLASS_INFO);
+
+    qRegisterMetaType<CaptureSnapshot>("CaptureSnapshot");
+
+    mHasLast = false;
+    for (int i = 0; i < CHANNEL_COUNT; ++i) {
+        mRateValues[i] = 0;
+        mRateTimes[i] = -1;
+    }
+    mPending = false;
+    mEnabled = true;
+    mTriggerTime = 0;
+
+    setBufferSize(CAPTURE_DEFAULT_FRAMES);
+    setWindow(CAPTURE_DEFAULT_PRE, CAPTURE_DEFAULT_POST);
+
+    /* capture data when any alert goes up (default) */
+    addTrigger("alert");
+
+    /* writer works in separate thread, snapshots are passed by queued signal */
+    mWriter = new CaptureWriter();
+    mWriter->moveToThread(&mThread);
+    connect (&mThread, &QThread::finished, mWriter, &QObject::deleteLater);
+    connect (this, &Capture::snapshotReady, mWriter, &CaptureWriter::write);
+    connect (mWriter, &CaptureWriter::written, this,
+                [=] (QString path, bool ok) {
+                    if (ok)
+                        emit printMessage(QString("capture saved to %1").arg(path), 1);
+                    else
+                        emit printMessage(QString("cannot save capture to %1").arg(path), 2);
+                });
+    mThread.start(QThread::LowPriority);
+
+    mClock.start();
+}
+
+
+Capture::~Capture()
+{
+    LOG (LOG_CONNECTIONS, "%s - in destructor", CLASS_INFO);
+
+    flush();
+    mThread.quit();
+    mThread.wait();
+}
+
+
+qint64 Capture::now(void) const
+{
+    return mClock.nsecsElapsed() / 1000;
+}
+
+
+void Capture::addFrame(quint32 id, const quint8 *data, int len)
+{
+    CaptureFrame &frame = mFrames[mFrameHead];
+
+    frame.time = now();
+    frame.id = id;
+    frame.len = qBound(0, len, 8);
+    for (int i = 0; i < frame.len; ++i)
+        frame.data[i] = data[i];
+
+    mFrameHead = (mFrameHead + 1) % mFrames.size();
+    if (mFrameCount < mFrames.size())
+        mFrameCount++;
+}
+
+
+void Capture::addSample(const float *values, quint16 alerts, quint32 channels, qint64 received)
+{
+    CaptureSample &sample = mSamples[mSampleHead];
+
+    sample.time = now();
+    sample.alerts = alerts;
+    for (int i = 0; i < CHANNEL_COUNT; ++i)
+        sample.values[i] = values[i];
+
+    mSampleHead = (mSampleHead + 1) % mSamples.size();
+    if (mSampleCount < mSamples.size())
+        mSampleCount++;
+
+    if (mPending) {
+        /* post-trigger window complete */
+        if (sample.time >= mTriggerTime + mPost)
+            takeSnapshot();
+    } else if (mEnabled) {
+        int fired = checkTriggers(sample, channels, received);
+        if (fired >= 0) {
+            mPending = true;
+            mTriggerTime = sample.time;
+            mTriggerDate = QDateTime::currentDateTime();
+            mReason = mDefinitions.at(fired);
+
+            LOG (LOG_CONNECTIONS, "%s - trigger \"%s\" fired", CLASS_INFO, STR(mReason));
+            emit printMessage(QString("capture trigger \"%1\"").arg(mReason), 1);
+        }
+    }
+
+    mLast = sample;
+    mHasLast = true;
+
+    /* rate is measured from the previous frame of channel with an earlier time (frame or read time) */
+    for (int i = 0; i < CHANNEL_COUNT; ++i) {
+        if ((channels & (1 << i)) && received > mRateTimes[i]) {
+            mRateValues[i] = values[i];
+            mRateTimes[i] = received;
+        }
+    }
+}
+
+
+int Capture::checkTriggers(const CaptureSample &sample, quint32 channels, qint64 received)
+{
+    for (int i = 0; i < mTriggers.size(); ++i) {
+        const Trigger &t = mTriggers.at(i);
+
+        if (t.type == TRIGGER_ALERT) {
+            quint16 last = mHasLast ? mLast.alerts : 0;
+            if (sample.alerts & ~last)
+                return i;
+            continue;
+        }
+
+        if (!mHasLast)
+            continue;
+
+        float value = sample.values[t.channel];
+        float last = mLast.values[t.channel];
+
+        switch (t.type) {
+        case TRIGGER_ABOVE:
+            if (last <= t.level && value > t.level)
+                return i;
+            break;
+        case TRIGGER_BELOW:
+            if (last >= t.level && value < t.level)
+                return i;
+            break;
+        case TRIGGER_RATE:
+            /* frames of other types interleave, channel is compared with its own previous frame */
+            if ((channels & (1 << t.channel)) && mRateTimes[t.channel] >= 0 && received > mRateTimes[t.channel] &&
+                    qAbs(value - mRateValues[t.channel]) * US_PER_SEC / (received - mRateTimes[t.channel]) > t.level)
+                return i;
+            break;
+        }
+    }
+
+    return -1;
+}
+
+
+void Capture::takeSnapshot(void)
+{
+    CaptureSnapshot snapshot;
+    qint64 from = mTriggerTime - mPre;
+
+    snapshot.reason = mReason;
+    snapshot.date = mTriggerDate;
+    snapshot.triggerTime = mTriggerTime;
+    snapshot.frames.reserve(mFrameCount);
+    snapshot.samples.reserve(mSampleCount);
+
+    /* walk rings from the oldest element */
+    for (int i = 0; i < mFrameCount; ++i) {
+        const CaptureFrame &frame = mFrames.at((mFrameHead - mFrameCount + i + mFrames.size()) % mFrames.size());
+        if (frame.time >= from)
+            snapshot.frames.append(frame);
+    }
+    for (int i = 0; i < mSampleCount; ++i) {
+        const CaptureSample &sample = mSamples.at((mSampleHead - mSampleCount + i + mSamples.size()) % mSamples.size());
+        if (sample.time >= from)
+            snapshot.samples.append(sample);
+    }
+
+    LOG (LOG_CONNECTIONS, "%s - snapshot of %d frames and %d samples", CLASS_INFO,
+         snapshot.frames.size(), snapshot.samples.size());
+
+    mPending = false;
+    emit snapshotReady(snapshot);
+}
+
+
+void Capture::flush(void)
+{
+    if (mPending)
+        takeSnapshot();
+}
+
+
+bool Capture::addTrigger(const QString &definition)
+{
+    QStringList tokens = definition.simplified().split(' ');
+    Trigger trigger;
+    bool valid = false;
+
+    if (tokens.size() == 1 && tokens.at(0) == "alert") {
+        trigger.type = TRIGGER_ALERT;
+        trigger.channel = 0;
+        trigger.level = 0;
+        valid = true;
+    } else if (tokens.size() == 3) {
+        trigger.channel = -1;
+        for (int i = 0; i < CHANNEL_COUNT; ++i) {
+            if (tokens.at(0) == channelNames[i])
+                trigger.channel = i;
+        }
+        trigger.level = tokens.at(2).toFloat(&valid);
+
+        if (tokens.at(1) == ">")
+            trigger.type = TRIGGER_ABOVE;
+        else if (tokens.at(1) == "<")
+            trigger.type = TRIGGER_BELOW;
+        else if (tokens.at(1) == "rate")
+            trigger.type = TRIGGER_RATE;
+        else
+            valid = false;
+
+        if (trigger.channel < 0)
+            valid = false;
+    }
+
+    if (!valid) {
+        LOG (LOG_CONNECTIONS, "%s - wrong trigger \"%s\"", CLASS_INFO, STR(definition));
+        emit printMessage(QString("wrong capture trigger \"%1\"").arg(definition), 2);
+        return false;
+    }
+
+    LOG (LOG_CONNECTIONS, "%s - added trigger \"%s\"", CLASS_INFO, STR(definition));
+
+    mTriggers.append(trigger);
+    mDefinitions.append(definition.simplified());
+
+    return true;
+}
+
+
+void Capture::clearTriggers(void)
+{
+    mTriggers.clear();
+    mDefinitions.clear();
+    mPending = false;
+}
+
+
+const QStringList &Capture::getTriggers(void)
+{
+    return mDefinitions;
+}
+
+
+void Capture::setBufferSize(int frames)
+{
+    LOG (LOG_CONNECTIONS, "%s - ring size %d", CLASS_INFO, frames);
+
+    if (frames <= 0)
+        frames = CAPTURE_DEFAULT_FRAMES;
+
+    /* memory is allocated once, rings are overwritten in place */
+    mFrames.fill(CaptureFrame(), frames);
+    mSamples.fill(CaptureSample(), frames);
+    mFrameHead = mFrameCount = 0;
+    mSampleHead = mSampleCount = 0;
+    mPending = false;
+}
+
+
+int Capture::getBufferSize(void)
+{
+    return mFrames.size();
+}
+
+
+void Capture::setWindow(double pre, double post)
+{
+    LOG (LOG_CONNECTIONS, "%s - window pre %.2f s, post %.2f s", CLASS_INFO, pre, post);
+
+    mPre = qMax(0.0, pre) * US_PER_SEC;
+    mPost = qMax(0.0, post) * US_PER_SEC;
+}
+
+
+double Capture::getPreTrigger(void)
+{
+    return mPre / US_PER_SEC;
+}
+
+
+double Capture::getPostTrigger(void)
+{
+    return mPost / US_PER_SEC;
+}
+
+
+void Capture::setEnabled(bool enable)
+{
+    LOG (LOG_CONNECTIONS, "%s - triggers %s", CLASS_INFO, enable ? "enabled" : "disabled");
+
+    mEnabled = enable;
+    if (!enable)
+        mPending = false;
+}
+
+
+bool Capture::isEnabled(void)
+{
+    return mEnabled;
+}
+
+/* ------------------------------------------ */
+
+void CaptureWriter::write(const CaptureSnapshot &snapshot)
+{
+    QString base = QString("%1/capture_%2").arg(CAPTURE_DIR)
+            .arg(snapshot.date.toString("yyyyMMdd_hhmmss_zzz"));
+
+    if (!QDir().mkpath(CAPTURE_DIR)) {
+        emit written(CAPTURE_DIR, false);
+        return;
+    }
+
+    /* raw frames in candump format (can be replayed by can_simulation.py) */
+    QFile log(base + ".log");
+    if (!log.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        emit written(log.fileName(), false);
+        return;
+    }
+
+    QTextStream logOut(&log);
+    for (int i = 0; i < snapshot.frames.size(); ++i) {
+        const CaptureFrame &frame = snapshot.frames.at(i);
+        logOut << "  can0  " << QString::number(frame.id, 16).toUpper().rightJustified(8, '0')
+               << "   [" << frame.len << "] ";
+        for (int j = 0; j < frame.len; ++j)
+            logOut << " " << QString::number(frame.data[j], 16).toUpper().rightJustified(2, '0');
+        logOut << "\n";
+    }
+    log.close();
+
+    /* decoded samples, time relative to trigger */
+    QFile csv(base + ".csv");
+    if (!csv.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        emit written(csv.fileName(), false);
+        return;
+    }
+
+    QTextStream csvOut(&csv);
+    csvOut << "# trigger: " << snapshot.reason << ", "
+           << snapshot.date.toString("yyyy-MM-dd hh:mm:ss.zzz") << "\n";
+    csvOut << "time_ms,alerts";
+    for (int i = 0; i < CHANNEL_COUNT; ++i)
+        csvOut << "," << channelNames[i];
+    csvOut << "\n";
+
+    for (int i = 0; i < snapshot.samples.size(); ++i) {
+        const CaptureSample &sample = snapshot.samples.at(i);
+        csvOut << QString::number((sample.time - snapshot.triggerTime) / 1000.0, 'f', 3)
+               << "," << QString("%1").arg(sample.alerts, 4, 16, QChar('0'));
+        for (int j = 0; j < CHANNEL_COUNT; ++j)
+            csvOut << "," << sample.values[j];
+        csvOut << "\n";
+    }
+    csv.close();
+
+    emit written(base, true);
+}
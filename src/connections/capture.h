@@ -0,0 +1,166 @@
+/**
+ * \class Capture
+ *
+ * \brief
+ *
+ * This class keeps always-on, fixed size rings of the latest raw CAN frames
+ * and decoded samples. When one of the configured triggers fires (alert bit
+ * set, value crossing a threshold, too fast rate of change) a window of
+ * pre- and post-trigger data is copied out of the rings and written to disk
+ * by CaptureWriter in a separate thread, so ingestion is never stopped.
+ *
+ * Trigger definitions (settings.conf, "Capture" section):
+ *      alert                   - any alert bit goes up
+ *      <channel> > <level>     - value rises above level
+ *      <channel> < <level>     - value falls below level
+ *      <channel> rate <level>  - value changes faster than level per second
+ *
+ * \version 1.0
+ *
+ * \date 2019/02/14 20:11:05
+ *
+ */
+#ifndef CAPTURE_H
+#define CAPTURE_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QThread>
+#include "../common/telemetry.h"
+
+#define CAPTURE_DEFAULT_FRAMES      8192
+#define CAPTURE_DEFAULT_PRE         5.0
+#define CAPTURE_DEFAULT_POST        2.0
+#define CAPTURE_DIR                 "captures"
+
+struct CaptureFrame {
+    qint64 time; /// - receive time [us]
+    quint32 id; /// - CAN identifier
+    quint8 len; /// - number of data bytes
+    quint8 data[8]; /// - payload
+};
+
+struct CaptureSample {
+    qint64 time; /// - decode time [us]
+    quint16 alerts; /// - alert bits
+    float values[CHANNEL_COUNT]; /// - decoded values
+};
+
+struct CaptureSnapshot {
+    QString reason; /// - description of trigger
+    QDateTime date; /// - wall clock time of trigger
+    qint64 triggerTime; /// - trigger time [us]
+    QVector<CaptureFrame> frames; /// - frames from capture window
+    QVector<CaptureSample> samples; /// - samples from capture window
+};
+
+Q_DECLARE_METATYPE(CaptureSnapshot)
+
+
+class CaptureWriter : public QObject
+{
+    Q_OBJECT
+
+public slots:
+    /// writes snapshot to CAPTURE_DIR (candump log of frames and csv of samples)
+    void write(const CaptureSnapshot &snapshot);
+
+signals:
+    /// signal emitted when snapshot was written
+    void written(QString, bool);
+};
+
+
+class Capture : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit Capture(QObject *parent = 0);
+    ~Capture();
+
+    /// returns current time of capture clock [us]
+    qint64 now(void) const;
+    /// stores raw frame in the ring
+    void addFrame(quint32 id, const quint8 *data, int len);
+    /**
+     * @brief addSample - stores decoded sample in the ring and checks triggers
+     * @param values - latest values of all channels
+     * @param alerts - alert bits
+     * @param channels - bit mask of channels decoded from the frame (rate of change)
+     * @param received - time of the frame [us] (candump timestamp or time of read)
+     */
+    void addSample(const float *values, quint16 alerts, quint32 channels, qint64 received);
+    /// writes pending capture even if post-trigger window is not complete
+    void flush(void);
+
+    /// parses and adds trigger definition, returns false if definition is wrong
+    bool addTrigger(const QString &definition);
+    /// removes all triggers
+    void clearTriggers(void);
+    /// returns list of trigger definitions
+    const QStringList &getTriggers(void);
+    /// sets ring size (number of frames and samples kept)
+    void setBufferSize(int frames);
+    int getBufferSize(void);
+    /// sets pre and post trigger window [s]
+    void setWindow(double pre, double post);
+    double getPreTrigger(void);
+    double getPostTrigger(void);
+    /// enables/disables triggers
+    void setEnabled(bool enable);
+    bool isEnabled(void);
+
+signals:
+    /// signal emitted when snapshot is ready to write (queued to writer thread)
+    void snapshotReady(CaptureSnapshot);
+    /// signal emitted with message to print
+    void printMessage(QString, int);
+
+private:
+    enum TriggerType {
+        TRIGGER_ALERT,
+        TRIGGER_ABOVE,
+        TRIGGER_BELOW,
+        TRIGGER_RATE
+    };
+
+    struct Trigger {
+        int type; /// - TriggerType
+        int channel; /// - index of telemetry channel
+        float level; /// - threshold or rate [1/s]
+    };
+
+    /// checks all triggers against new sample, returns index of fired trigger or -1
+    int checkTriggers(const CaptureSample &sample, quint32 channels, qint64 received);
+    /// copies capture window out of rings and passes it to writer
+    void takeSnapshot(void);
+
+    QVector<CaptureFrame> mFrames; /// - ring of raw frames
+    QVector<CaptureSample> mSamples; /// - ring of decoded samples
+    int mFrameHead, mFrameCount; /// - next write position and number of stored frames
+    int mSampleHead, mSampleCount; /// - next write position and number of stored samples
+    CaptureSample mLast; /// - previous sample (edges and rate of change)
+    bool mHasLast; /// - keeps information whether mLast is valid
+    float mRateValues[CHANNEL_COUNT]; /// - value of channel from its previous frame (rate of change)
+    qint64 mRateTimes[CHANNEL_COUNT]; /// - receive time of previous frame of channel [us], -1 if none
+
+    QVector<Trigger> mTriggers; /// - parsed triggers
+    QStringList mDefinitions; /// - trigger definitions (saved to config)
+    qint64 mPre, mPost; /// - capture window [us]
+    bool mEnabled; /// - keeps information whether triggers are checked
+    bool mPending; /// - keeps information whether post-trigger data is collected
+    qint64 mTriggerTime; /// - time of pending trigger [us]
+    QString mReason; /// - description of pending trigger
+    QDateTime mTriggerDate; /// - wall clock time of pending trigger
+
+    QElapsedTimer mClock; /// - monotonic clock of captured data
+    QThread mThread; /// - thread of writer
+    CaptureWriter *mWriter; /// - writes snapshots to disk
+};
+
+#endif // CAPTURE_H
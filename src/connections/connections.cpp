@@ -2,13 +2,34 @@
 #include <QByteArrayList>
 #include <QDir>
 #include <QFileInfo>
+#include <QTimer>
+#include <cstring>
 #include "connections.h"
 #include "../common/logger.h"
 #include "../common/parameters.h"
+#include "../common/pipeline.h"
 
 #define CLASS_INFO              "connections"
 #define DEFAULT_CAN_MODE        0
 #define DEFAULT_CAN_BAUD        250000
+#define TELEMETRY_COMPUTED      (1 << CHANNEL_COUNT)
+
+/* values closer than dead-band to the last emitted one are not emitted */
+static const float deadBands[CHANNEL_COUNT] = {
+    10,     /* rpm */
+    0,      /* current [A] */
+    0,      /* voltage [V] */
+    0.05,   /* power [kW] */
+    0,      /* throttle [%] */
+    0,      /* controller temp [C] */
+    0       /* motor temp [C] */
+};
+
+/* telemetry channels decoded from frame types (MESSAGE_1, MESSAGE_2) */
+static const quint32 frameChannels[] = {
+    (1 << CHANNEL_RPM) | (1 << CHANNEL_CURRENT) | (1 << CHANNEL_VOLTAGE) | (1 << CHANNEL_POWER),
+    (1 << CHANNEL_THROTTLE) | (1 << CHANNEL_CONTR_TEMP) | (1 << CHANNEL_MOTOR_TEMP)
+};
 
 
 
@@ -25,6 +46,24 @@ Connections::Connections(RpmWidget *m_rpm, Alerts *m_alerts)
     mCanMode = DEFAULT_CAN_MODE;
     mCanBaud = DEFAULT_CAN_BAUD;
 
+    for (int i = 0; i < CHANNEL_COUNT; ++i)
+        mValues[i] = 0;
+    mAlertMask = 0;
+    mAlertsValid = false;
+    mTelemetryMask = 0;
+    mTelemetryReceived = 0;
+    mFlushScheduled = false;
+    mFrameOffset = 0;
+    mFrameOffsetValid = false;
+    mEmittedMask = 0;
+    for (int i = 0; i < FRAME_TYPES; ++i)
+        mFrames[i].valid = false;
+    mCanEchoShed = false;
+
+    /* always-on capture of latest data */
+    capture = new Capture(this);
+    connect (capture, &Capture::printMessage,
+                this, &Connections::printMessage);
 }
 
 
@@ -39,7 +78,7 @@ void Connections::initializeSignalsAndSlots(void)
     LOG (LOG_CONNECTIONS, "%s - initializing signals", CLASS_INFO);
 
     connect (this, &Connections::updateAlerts, rpm,
-             [=](char errors[16]) { alerts->updateAlertsState(errors); });
+             [=](quint16 mask) { alerts->updateAlertsState(mask); });
 }
 
 
@@ -150,11 +189,24 @@ int Connections::initializeCanInterface(void)
 
 void Connections::closeConnection(void)
 {
+    capture->flush();
     process->close();
     isConnected = false;
+    mBuffer.clear();
+    mFrameOffsetValid = false;
+    mAlertsValid = false;
+    printLaneStats();
+    for (int i = 0; i < LANE_COUNT; ++i)
+        laneStats[i].reset();
+    for (int i = 0; i < STAGE_COUNT; ++i)
+        gStages[i].reset();
+    for (int i = 0; i < FRAME_TYPES; ++i)
+        mFrames[i].valid = false;
+    mEmittedMask = 0;
     avgRpm.clear();
     avgCurrent.clear();
     avgVoltage.clear();
+    avgPower.clear();
     delete process;
     emit setConnectionStateButton(getConnectionStatus());
     emit enableRadioButtons(true);
@@ -185,77 +237,157 @@ void Connections::establishConnection(void)
 
 void Connections::readLine()
 {
-    /* read output (unsplitted line) */
-    QByteArray data_Uns(process->readAllStandardOutput().simplified());
+    /* read output, it can contain more than one line when GUI is late */
+    feed(process->readAllStandardOutput());
+}
+
+
+void Connections::feed(const QByteArray &data)
+{
+    mBuffer.append(data);
+
+    /* every line gets its own time, values of one read are not weighted as simultaneous */
+    int start = 0, end;
+    while ((end = mBuffer.indexOf('\n', start)) != -1) {
+        QByteArray line(mBuffer.mid(start, end - start).simplified());
+        if (!line.isEmpty())
+            decodeLine(line, capture->now());
+        start = end + 1;
+    }
+    /* keep incomplete line for next read */
+    mBuffer.remove(0, start);
+
+    /* telemetry lane is delivered after already queued events */
+    if (mTelemetryMask && !mFlushScheduled) {
+        mFlushScheduled = true;
+        QTimer::singleShot(0, this, &Connections::flushTelemetry);
+    }
+}
+
+
+void Connections::decodeLine(const QByteArray &line, qint64 received)
+{
     LOG (LOG_CONNECTIONS_DATA, "%s - got line - %s", CLASS_INFO, \
-             data_Uns.toStdString().c_str());
+             line.constData());
 
     /* split data */
-    QString data_s (data_Uns);
+    QString data_s (line);
     QStringList data(data_s.split(' '));
 
-    if (data.isEmpty())
-        return;
+    /* candump -t a prefixes line with time of frame, it replaces time of read */
+    if (data[0].startsWith('(')) {
+        received = frameTime(data[0], received);
+        data.removeFirst();
+    }
 
-    if (data[0] != "can0") {
+    if (data.isEmpty() || data[0] != "can0") {
         LOG (LOG_CONNECTIONS_DATA, "%s - wrong CAN data - %s", CLASS_INFO, \
                  data_s.toStdString().c_str());
         emit printMessage(QString("wrong CAN data: %1").arg(data_s), 2);
         return;
     }
 
-    if (mCanToConsole)
+    if (mCanToConsole && !mCanEchoShed)
         emit printMessage(QString("data - %1").arg(data_s), 1);
 
     /* remove first element (interface name - can0) */
     data.removeFirst();
 
+    /* keep raw frame in capture ring */
+    quint8 payload[8];
+    int len = 0;
+    if (data.size() >= 2) {
+        len = qMin(data.size() - 2, 8);
+        for (int i = 0; i < len; ++i)
+            payload[i] = data[i + 2].toUInt(NULL, 16);
+        capture->addFrame(data[0].toUInt(NULL, 16), payload, len);
+    }
+
+    /* skip decoding of payload identical to the previous one */
+    int type = (data[0] == MESSAGE_1) ? FRAME_1 : (data[0] == MESSAGE_2) ? FRAME_2 : -1;
+    if (type >= 0 && !stageCount(STAGE_FRAMES, frameChanged(type, payload, len))) {
+        /* values of skipped frame still hold, history (charts) must not see a gap */
+        for (int i = 0; i < CHANNEL_COUNT; ++i) {
+            if (frameChannels[type] & (1 << i)) {
+                mHistory.repeat(i, received);
+                mDistribution.hold(i, received);
+            }
+        }
+        for (int i = 0; i < mChannels.size(); ++i)
+            mHistory.repeat(CHANNEL_COUNT + i, received);
+        capture->addSample(mValues, mAlertMask, frameChannels[type], received);
+        return;
+    }
+
     int lsb, msb;
     bool valid_l, valid_m;
 
-    if (data[0] == MESSAGE_1) {
+    if (data[0] == MESSAGE_1 && data.size() >= 10) {
 
         /* remove first 2 elements (no of bytes and address */
         for (int i = 0; i <= 1; i++)
             data.removeFirst();
+
+        /* read converter alerts first (alerts lane) */
+        lsb = data[6].toUInt(&valid_l, 16);
+        msb = data[7].toUInt(&valid_m, 16);
+        if (valid_l && valid_m) {
+            quint16 mask = msb*256 + lsb;
+            /* deliver only transitions */
+            if (!mAlertsValid || mask != mAlertMask) {
+                mAlertMask = mask;
+                mAlertsValid = true;
+                emit updateAlerts(mask);
+                laneStats[LANE_ALERTS].add(capture->now() - received);
+            }
+        }
+
         /* read rpm speed (base 16) */
         lsb = data[0].toUInt(&valid_l, 16);
         msb = data[1].toUInt(&valid_m, 16);
         quint16 rpm = msb*256 + lsb;
+        quint16 avg = rpm;
         if (valid_l && valid_m) /* update rpm widget (8 samples) */
-            emit updateRpmSpeed(calculateAvg(avgRpm, rpm, 8));
+            queueTelemetry(CHANNEL_RPM, avg = calculateAvg(avgRpm, rpm, 8), received);
+        bool settled = (avg == rpm);
         /* read battery current (base 16) */
         lsb = data[2].toUInt(&valid_l, 16);
         msb = data[3].toUInt(&valid_m, 16);
         quint16 current = (msb*256 + lsb)/10;
+        avg = current;
         if (valid_l && valid_m) /* update current (6 samples) */
-            emit updateBatteryCurrent(calculateAvg(avgCurrent, current, 6));
+            queueTelemetry(CHANNEL_CURRENT, avg = calculateAvg(avgCurrent, current, 6), received);
+        settled = settled && (avg == current);
         /* read battery voltage (base 16) */
         lsb = data[4].toUInt(&valid_l, 16);
         msb = data[5].toUInt(&valid_m, 16);
         quint16 voltage = (msb*256 + lsb)/10;
+        avg = voltage;
         if (valid_l && valid_m) /* update voltage (5 samples) */
-            emit updateBatteryVoltage(calculateAvg(avgVoltage, voltage, 5));
+            queueTelemetry(CHANNEL_VOLTAGE, avg = calculateAvg(avgVoltage, voltage, 5), received);
+        settled = settled && (avg == voltage);
         /* calculate power */
         float power = current * voltage;
         power = power/1000; /* update power (5 samples) */
-        emit updatePower(calculateAvg(avgPower, power, 5));
+        float avgP = calculateAvg(avgPower, power, 5);
+        queueTelemetry(CHANNEL_POWER, avgP, received);
+        settled = settled && qAbs(avgP - power) <= deadBands[CHANNEL_POWER];
 
-        /* read converter alerts */
-        lsb = data[6].toUInt(&valid_l, 16);
-        msb = data[7].toUInt(&valid_m, 16);
-        char array[16];
-        for (int i = 0; i < 8; ++i) {
-            array[i] = (lsb >> i) & 1;
-            array[i+8] = (msb >> i) & 1;
-        }
-        if (valid_l && valid_m)
-            emit updateAlerts(array);
+        /* identical payload can be skipped only when averages reached input */
+        mFrames[FRAME_1].settled = settled;
+
+        mValues[CHANNEL_RPM] = rpm;
+        mValues[CHANNEL_CURRENT] = current;
+        mValues[CHANNEL_VOLTAGE] = voltage;
+        mValues[CHANNEL_POWER] = power;
 
         LOG (LOG_CONNECTIONS_DATA, "%s - %s - rpm: %d\t current: %d\t voltage: %d\t power: %.2f",
              CLASS_INFO, MESSAGE_1, rpm, current, voltage, power);
 
-    } else if (data[0] == MESSAGE_2) {
+        updateComputedChannels(received);
+        capture->addSample(mValues, mAlertMask, frameChannels[FRAME_1], received);
+
+    } else if (data[0] == MESSAGE_2 && data.size() >= 5) {
 
         /* remove first 2 elements (no of bytes and address */
         for (int i = 0; i <= 1; i++)
@@ -264,47 +396,291 @@ void Connections::readLine()
         lsb = data[0].toUInt(&valid_l, 16);
         quint16 throttle = lsb/2.55;
         if (valid_l)
-            emit updateThrottle(throttle);
+            queueTelemetry(CHANNEL_THROTTLE, throttle, received);
         /* read controller temperature (base 16) */
         lsb = data[1].toUInt(&valid_l, 16);
         quint16 controllerTemp = lsb - 40;
         if (valid_l)
-            emit updateControllerTemp(controllerTemp);
+            queueTelemetry(CHANNEL_CONTR_TEMP, controllerTemp, received);
         /* read motor temperature (base 16) */
         lsb = data[2].toUInt(&valid_l, 16);
         quint16 motorTemp = lsb - 30;
         if (valid_l)
-            emit updateMotorTemp(motorTemp);
+            queueTelemetry(CHANNEL_MOTOR_TEMP, motorTemp, received);
+
+        mValues[CHANNEL_THROTTLE] = throttle;
+        mValues[CHANNEL_CONTR_TEMP] = controllerTemp;
+        mValues[CHANNEL_MOTOR_TEMP] = motorTemp;
+
+        /* no averaging, identical payload can be always skipped */
+        mFrames[FRAME_2].settled = true;
 
         LOG (LOG_CONNECTIONS_DATA, "%s - %s - throttle: %d\t cont temp: %d\t motor temp: %d",
              CLASS_INFO, MESSAGE_2, throttle, controllerTemp, motorTemp);
+
+        updateComputedChannels(received);
+        capture->addSample(mValues, mAlertMask, frameChannels[FRAME_2], received);
     }
 }
 
 
-template <typename T> T Connections::calculateAvg(QVector<T> &container, T value, quint16 _size)
+bool Connections::frameChanged(int type, const quint8 *payload, int len)
 {
-    if (value == 0 || container.isEmpty())
+    FrameCache &frame = mFrames[type];
+
+    if (frame.valid && frame.settled && frame.len == len && !memcmp(frame.payload, payload, len))
+        return false;
+
+    memcpy(frame.payload, payload, len);
+    frame.len = len;
+    frame.valid = true;
+    frame.settled = false;
+
+    return true;
+}
+
+
+qint64 Connections::frameTime(const QString &stamp, qint64 received)
+{
+    bool ok;
+    qint64 time = qint64(stamp.mid(1, stamp.size() - 2).toDouble(&ok) * 1000000);
+    if (!ok)
+        return received;
+
+    /* the smallest delay maps CAN clock to capture clock, frames stay ordered and never in future */
+    if (!mFrameOffsetValid || received - time < mFrameOffset) {
+        mFrameOffset = received - time;
+        mFrameOffsetValid = true;
+    }
+
+    return time + mFrameOffset;
+}
+
+
+void Connections::queueTelemetry(int channel, float value, qint64 received)
+{
+    /* history and distributions keep every decoded value, dead-bands apply only to delivery */
+    mHistory.add(channel, value, received);
+    mDistribution.add(channel, value, received);
+
+    /* value inside dead-band of the last emitted one is not emitted */
+    if (!stageCount(STAGE_EMIT, !(mEmittedMask & (1 << channel)) ||
+                    qAbs(value - mEmitted[channel]) > deadBands[channel])) {
+        mTelemetryMask &= ~(1 << channel);
+        return;
+    }
+
+    if (mTelemetryMask & (1 << channel))
+        laneStats[LANE_TELEMETRY].coalesced++;
+    else if (!mTelemetryMask)
+        mTelemetryReceived = received;
+
+    mTelemetry[channel] = value;
+    mTelemetryMask |= (1 << channel);
+}
+
+
+void Connections::flushTelemetry(void)
+{
+    quint32 mask = mTelemetryMask;
+
+    mFlushScheduled = false;
+    mTelemetryMask = 0;
+
+    if (mask & (1 << CHANNEL_RPM))
+        emit updateRpmSpeed(mTelemetry[CHANNEL_RPM]);
+    if (mask & (1 << CHANNEL_CURRENT))
+        emit updateBatteryCurrent(mTelemetry[CHANNEL_CURRENT]);
+    if (mask & (1 << CHANNEL_VOLTAGE))
+        emit updateBatteryVoltage(mTelemetry[CHANNEL_VOLTAGE]);
+    if (mask & (1 << CHANNEL_POWER))
+        emit updatePower(mTelemetry[CHANNEL_POWER]);
+    if (mask & (1 << CHANNEL_THROTTLE))
+        emit updateThrottle(mTelemetry[CHANNEL_THROTTLE]);
+    if (mask & (1 << CHANNEL_CONTR_TEMP))
+        emit updateControllerTemp(mTelemetry[CHANNEL_CONTR_TEMP]);
+    if (mask & (1 << CHANNEL_MOTOR_TEMP))
+        emit updateMotorTemp(mTelemetry[CHANNEL_MOTOR_TEMP]);
+
+    for (int i = 0; i < CHANNEL_COUNT; ++i) {
+        if (mask & (1 << i))
+            mEmitted[i] = mTelemetry[i];
+    }
+    mEmittedMask |= mask;
+
+    /* computed channels share telemetry lane */
+    if (mask & TELEMETRY_COMPUTED) {
+        for (int i = 0; i < mComputed.size(); ++i)
+            emit updateComputedChannel(i, mComputed.at(i));
+    }
+
+    if (mask) {
+        laneStats[LANE_TELEMETRY].add(capture->now() - mTelemetryReceived);
+        emit telemetryDelivered(mTelemetryReceived);
+    }
+}
+
+
+qint64 Connections::getBacklog(void)
+{
+    if (!isConnected)
         return 0;
 
-    T avgValue = 0;
-    container.resize(_size);
+    return process->bytesAvailable() + mBuffer.size();
+}
 
-    for (int i = 0 ; i < container.size(); ++i) {
-        avgValue = avgValue + container.at(i);
-        if (container.at(i) == 0) {
-            container.insert(i, value);
-            break;
-        } else if (i == container.size()-1){
-            container.insert(i+1, value);
-            container.pop_front();
-            break;
+
+void Connections::setCanEchoShed(bool shed)
+{
+    mCanEchoShed = shed;
+}
+
+
+const LaneStats &Connections::getLaneStats(int lane)
+{
+    return laneStats[qBound(0, lane, LANE_COUNT - 1)];
+}
+
+
+void Connections::printLaneStats(void)
+{
+    for (int i = 0; i < LANE_COUNT; ++i) {
+        const LaneStats &stats = laneStats[i];
+        QString msg = QString("%1 lane: %2 delivered, %3 coalesced, latency mean %4 ms, max %5 ms")
+                .arg(laneNames[i]).arg(stats.delivered).arg(stats.coalesced)
+                .arg(stats.meanLatency() / 1000, 0, 'f', 2).arg(stats.maxLatency / 1000.0, 0, 'f', 2);
+
+        LOG (LOG_CONNECTIONS, "%s - %s", CLASS_INFO, STR(msg));
+        emit printMessage(msg, 0);
+    }
+
+    /* work saved by change detection */
+    for (int i = 0; i < STAGE_COUNT; ++i) {
+        quint64 total = gStages[i].processed + gStages[i].skipped;
+        QString msg = QString("%1 stage: %2 processed, %3 skipped (%4%)")
+                .arg(stageNames[i]).arg(gStages[i].processed).arg(gStages[i].skipped)
+                .arg(total ? 100.0 * gStages[i].skipped / total : 0, 0, 'f', 1);
+
+        LOG (LOG_CONNECTIONS, "%s - %s", CLASS_INFO, STR(msg));
+        emit printMessage(msg, 0);
+    }
+}
+
+
+void Connections::updateComputedChannels(qint64 received)
+{
+    if (mChannels.isEmpty())
+        return;
+
+    /* evaluated for every decoded sample, delivered with telemetry lane */
+    bool changed = false;
+    for (int i = 0; i < mChannels.size(); ++i) {
+        float value = mChannels.at(i).expr.evaluate(mValues);
+        mHistory.add(CHANNEL_COUNT + i, value, received);
+        if (value != mComputed.at(i) || !(mEmittedMask & TELEMETRY_COMPUTED)) {
+            mComputed[i] = value;
+            changed = true;
         }
     }
 
-    avgValue = avgValue / container.size();
+    if (stageCount(STAGE_EMIT, changed))
+        mTelemetryMask |= TELEMETRY_COMPUTED;
+}
+
+
+bool Connections::addComputedChannel(const QString &name, const QString &source)
+{
+    LOG (LOG_CONNECTIONS, "%s - adding computed channel \"%s\" = %s", CLASS_INFO,
+         STR(name), STR(source));
+
+    ComputedChannel channel;
+    QString error;
+
+    channel.name = name;
+    if (!channel.expr.compile(source, error)) {
+        LOG (LOG_CONNECTIONS, "%s - computed channel \"%s\" error: %s", CLASS_INFO,
+             STR(name), STR(error));
+        emit printMessage(QString("computed channel \"%1\": %2").arg(name).arg(error), 2);
+        return false;
+    }
+
+    mChannels.append(channel);
+    mComputed.resize(mChannels.size());
+    mHistory.setInputs(CHANNEL_COUNT + mChannels.size());
+    mEmittedMask &= ~TELEMETRY_COMPUTED;
+    emit computedChannelsChanged();
+
+    return true;
+}
+
+
+void Connections::clearComputedChannels(void)
+{
+    LOG (LOG_CONNECTIONS, "%s - clearing computed channels", CLASS_INFO);
+
+    mChannels.clear();
+    mComputed.clear();
+    mHistory.setInputs(CHANNEL_COUNT);
+    mTelemetryMask &= ~TELEMETRY_COMPUTED;
+    mEmittedMask &= ~TELEMETRY_COMPUTED;
+    emit computedChannelsChanged();
+}
+
+
+int Connections::getComputedChannelCount(void)
+{
+    return mChannels.size();
+}
+
+
+QString Connections::getComputedChannelName(int index)
+{
+    if (index < 0 || index >= mChannels.size())
+        return QString();
+
+    return mChannels.at(index).name;
+}
 
-    return avgValue;
+
+QString Connections::getComputedChannelSource(int index)
+{
+    if (index < 0 || index >= mChannels.size())
+        return QString();
+
+    return mChannels.at(index).expr.getSource();
+}
+
+
+template <typename T> T Connections::calculateAvg(QVector<T> &container, T value, quint16 _size)
+{
+    /* moving average of last _size samples */
+    container.append(value);
+    while (container.size() > _size)
+        container.removeFirst();
+
+    T avgValue = 0;
+    for (int i = 0 ; i < container.size(); ++i)
+        avgValue = avgValue + container.at(i);
+
+    return avgValue / container.size();
+}
+
+
+Capture *Connections::getCapture(void)
+{
+    return capture;
+}
+
+
+const History *Connections::getHistory(void)
+{
+    return &mHistory;
+}
+
+
+Distribution *Connections::getDistribution(void)
+{
+    return &mDistribution;
 }
 
 
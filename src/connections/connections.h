@@ -24,6 +24,12 @@
 #include <QVector>
 #include "../main/rpmwidget.h"
 #include "../alerts/alerts.h"
+#include "../common/telemetry.h"
+#include "expression.h"
+#include "capture.h"
+#include "history.h"
+#include "distribution.h"
+#include "lanes.h"
 
 class Connections : public QObject
 {
@@ -44,6 +50,30 @@ public:
     bool getConnectionStatus();
     /// is a setter method changing value of isConnected property
     void setConnectionStatus(bool value);
+    /// compiles and adds computed channel, returns false if expression is wrong
+    bool addComputedChannel(const QString &name, const QString &source);
+    /// removes all computed channels
+    void clearComputedChannels(void);
+    /// returns number of computed channels
+    int getComputedChannelCount(void);
+    /// returns name of computed channel
+    QString getComputedChannelName(int index);
+    /// returns expression of computed channel
+    QString getComputedChannelSource(int index);
+    /// returns pointer to triggered capture of frames and samples
+    Capture *getCapture(void);
+    /// returns pointer to recent values of all signals
+    const History *getHistory(void);
+    /// returns distributions of telemetry channels (Statistics page)
+    Distribution *getDistribution(void);
+    /// returns number of bytes of CAN data waiting to be decoded
+    qint64 getBacklog(void);
+    /// enables/disables shedding of CAN data console output (overload)
+    void setCanEchoShed(bool shed);
+    /// returns delivery statistics of priority lane (Lane)
+    const LaneStats &getLaneStats(int lane);
+    /// decodes candump output as if it was read from CAN process (replay, benchmarks)
+    void feed(const QByteArray &data);
 
 private:
     /// is a method calculating average value of container
@@ -64,9 +94,40 @@ private:
     const QString getCanMode(void);
     /// method that returns information about CAN data check box
     bool isCanToConsoleEnabled(void);
+    /// evaluates computed channels with latest decoded values
+    void updateComputedChannels(qint64 received);
+    /// decodes single candump line
+    void decodeLine(const QByteArray &line, qint64 received);
+    /// returns capture clock time [us] of candump timestamp "(seconds)", received if it is not valid
+    qint64 frameTime(const QString &stamp, qint64 received);
+    /// stores value in telemetry lane (older pending value is replaced)
+    void queueTelemetry(int channel, float value, qint64 received);
+    /// prints delivery statistics of lanes and pipeline stages to console
+    void printLaneStats(void);
+    /// compares payload with previous frame of the same type, returns true if decoding is needed
+    bool frameChanged(int type, const quint8 *payload, int len);
+
+    enum FrameType {
+        FRAME_1, /// - MESSAGE_1 (rpm, current, voltage, alerts)
+        FRAME_2, /// - MESSAGE_2 (throttle, temperatures)
+        FRAME_TYPES
+    };
+
+    struct FrameCache {
+        quint8 payload[8]; /// - payload of last decoded frame
+        int len; /// - number of payload bytes
+        bool valid; /// - keeps information whether payload is valid
+        bool settled; /// - keeps information whether decoding the same payload gives the same output
+    };
+
+    struct ComputedChannel {
+        QString name; /// - name displayed in chart selector
+        Expression expr; /// - compiled expression
+    };
 
     bool canInitialized;
     bool mCanToConsole; /// - enable/disable output CAN data to console
+    bool mCanEchoShed; /// - CAN data output to console shed because of overload
     QString mFilePath; /// - keeps the path of python can simulation file
     bool mCanMode; /// - keeps an information about can mode (0-Converter, 1-Simulation)
     int mCanBaud; /// - keeps an information about can baudrate (125, 250, 500, 1000 kbit/s)
@@ -74,6 +135,25 @@ private:
     QVector <quint16> avgCurrent; /// - container that keeps samples of current
     QVector <quint16> avgVoltage; /// - container that keeps samples of voltage
     QVector <float> avgPower; /// - container that keeps samples of power
+    float mValues[CHANNEL_COUNT]; /// - latest decoded values (input of computed channels)
+    quint16 mAlertMask; /// - latest alert bits
+    bool mAlertsValid; /// - keeps information whether mAlertMask was delivered
+    QByteArray mBuffer; /// - incomplete line from last read
+    qint64 mFrameOffset; /// - capture clock minus candump time [us] (smallest delay seen)
+    bool mFrameOffsetValid; /// - keeps information whether mFrameOffset was measured
+    float mTelemetry[CHANNEL_COUNT]; /// - telemetry lane values waiting for delivery
+    QVector <float> mComputed; /// - computed channels values waiting for delivery
+    quint32 mTelemetryMask; /// - bit mask of waiting values (channels, computed)
+    qint64 mTelemetryReceived; /// - receive time of the oldest waiting value
+    bool mFlushScheduled; /// - keeps information whether telemetry flush is queued
+    LaneStats laneStats[LANE_COUNT]; /// - delivery statistics of lanes
+    FrameCache mFrames[FRAME_TYPES]; /// - last payloads (change detection)
+    float mEmitted[CHANNEL_COUNT]; /// - last emitted values (dead-bands)
+    quint32 mEmittedMask; /// - bit mask of channels emitted at least once
+    Capture *capture; /// - ring of latest frames and samples saved on trigger
+    History mHistory; /// - rings of recent values of all signals (charts)
+    Distribution mDistribution; /// - histograms of telemetry channels (lap, session)
+    QVector <ComputedChannel> mChannels; /// - user defined computed channels
     QProcess *process; /// - pointer of QProcess class
     RpmWidget *rpm; /// - pointer of RpmWidget class
     Alerts *alerts; /// - pointer of Alerts class
@@ -102,13 +182,21 @@ signals:
     /// signal emitted when motor temp data income
     void updateMotorTemp(quint16);
     /// signal emitted when alerts data income
-    void updateAlerts(char[]);
+    void updateAlerts(quint16);
+    /// signal emitted when computed channel value is calculated (index, value)
+    void updateComputedChannel(int, float);
+    /// signal emitted when list of computed channels changed
+    void computedChannelsChanged();
+    /// signal emitted when telemetry lane values were delivered (receive time of the oldest one [us])
+    void telemetryDelivered(qint64);
     /// signal emitted when connection error appears
     void printMessage(QString, int);
 
 public slots:
     /// method called when data is ready to read
     void readLine();
+    /// delivers latest values of telemetry lane
+    void flushTelemetry(void);
     /// method called when >Connect< button clicked
     void initializeConnection(void);
     /// method called when can mode changed
@@ -0,0 +1,175 @@
+#include "distribution.h"
+#include "../common/logger.h"
+
+#define CLASS_INFO          "distribution"
+
+
+Distribution::Distribution()
+{
+    LOG (LOG_CONNECTIONS, "%s - in constructor", CLASS_INFO);
+
+    for (int i = 0; i < CHANNEL_COUNT; ++i) {
+        mSignals[i].limits = defaultLimits[i];
+        mSignals[i].value = 0;
+        mSignals[i].time = -1;
+    }
+    reset(SCOPE_SESSION);
+}
+
+
+void Distribution::clear(DistributionHistogram &histogram)
+{
+    for (int i = 0; i < DISTRIBUTION_BINS; ++i)
+        histogram.bins[i] = 0;
+    histogram.time = histogram.beyond = 0;
+    histogram.sum = 0;
+    histogram.min = histogram.max = 0;
+    histogram.count = 0;
+}
+
+
+void Distribution::reset(int scope)
+{
+    LOG (LOG_CONNECTIONS, "%s - %s reset", CLASS_INFO, scope == SCOPE_LAP ? "lap" : "session");
+
+    for (int i = 0; i < CHANNEL_COUNT; ++i) {
+        clear(mSignals[i].scopes[SCOPE_LAP]);
+        if (scope == SCOPE_SESSION)
+            clear(mSignals[i].scopes[SCOPE_SESSION]);
+    }
+}
+
+
+void Distribution::add(int channel, float value, qint64 time)
+{
+    if (channel < 0 || channel >= CHANNEL_COUNT)
+        return;
+
+    Signal &signal = mSignals[channel];
+    count(signal, channel, time);
+
+    for (int i = 0; i < SCOPE_COUNT; ++i) {
+        extend(signal.scopes[i], value);
+        signal.scopes[i].count++;
+    }
+
+    signal.value = value;
+    signal.time = time;
+}
+
+
+void Distribution::hold(int channel, qint64 time)
+{
+    if (channel < 0 || channel >= CHANNEL_COUNT || mSignals[channel].time < 0)
+        return;
+
+    Signal &signal = mSignals[channel];
+    count(signal, channel, time);
+    signal.time = time;
+}
+
+
+void Distribution::count(Signal &signal, int channel, qint64 time)
+{
+    qint64 held = time - signal.time;
+    if (signal.time < 0 || held <= 0 || held > DISTRIBUTION_GAP)
+        return;
+
+    /* last value held until now */
+    int index = bin(channel, signal.value);
+    const ThresholdLimits &limits = signal.limits;
+    bool beyond = limits.isEnabled() && (limits.isFalling() ? signal.value < limits.warning :
+                                                              signal.value > limits.warning);
+
+    for (int i = 0; i < SCOPE_COUNT; ++i) {
+        DistributionHistogram &histogram = signal.scopes[i];
+        extend(histogram, signal.value);
+        histogram.bins[index] += held;
+        histogram.time += held;
+        histogram.sum += double(signal.value) * held;
+        if (beyond)
+            histogram.beyond += held;
+    }
+}
+
+
+void Distribution::extend(DistributionHistogram &histogram, float value)
+{
+    /* value held over reset of scope is its first value */
+    bool empty = !histogram.count && !histogram.time;
+
+    if (empty || value < histogram.min)
+        histogram.min = value;
+    if (empty || value > histogram.max)
+        histogram.max = value;
+}
+
+
+int Distribution::bin(int channel, float value) const
+{
+    float low = distributionRanges[channel][0];
+    float high = distributionRanges[channel][1];
+    int index = int((value - low) * DISTRIBUTION_BINS / (high - low));
+
+    return qBound(0, index, DISTRIBUTION_BINS - 1);
+}
+
+
+void Distribution::setLimits(int channel, const ThresholdLimits &limits)
+{
+    if (channel >= 0 && channel < CHANNEL_COUNT)
+        mSignals[channel].limits = limits;
+}
+
+
+bool Distribution::hasLimit(int channel) const
+{
+    return mSignals[channel].limits.isEnabled();
+}
+
+
+const DistributionHistogram &Distribution::get(int channel, int scope) const
+{
+    return mSignals[channel].scopes[scope];
+}
+
+
+float Distribution::getMean(int channel, int scope) const
+{
+    const DistributionHistogram &histogram = get(channel, scope);
+
+    /* single sample has no duration yet */
+    if (!histogram.time)
+        return histogram.count ? mSignals[channel].value : 0;
+
+    return histogram.sum / histogram.time;
+}
+
+
+float Distribution::getBinValue(int channel, int bin) const
+{
+    float low = distributionRanges[channel][0];
+    float high = distributionRanges[channel][1];
+
+    return low + (high - low) * bin / DISTRIBUTION_BINS;
+}
+
+
+float Distribution::getPercentile(int channel, int scope, qreal percentile) const
+{
+    const DistributionHistogram &histogram = get(channel, scope);
+    if (!histogram.time)
+        return getMean(channel, scope);
+
+    /* bin where cumulative time reaches percentile, interpolated inside it */
+    qreal target = histogram.time * qBound(0.0, percentile, 100.0) / 100;
+    qint64 cumulative = 0;
+    int i = 0;
+    while (i < DISTRIBUTION_BINS - 1 && cumulative + histogram.bins[i] < target)
+        cumulative += histogram.bins[i++];
+
+    qreal fraction = histogram.bins[i] ? (target - cumulative) / histogram.bins[i] : 0;
+    float value = getBinValue(channel, i) + (getBinValue(channel, i + 1) - getBinValue(channel, i)) * fraction;
+
+    return qBound(histogram.min, value, histogram.max);
+}
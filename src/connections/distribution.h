@@ -0,0 +1,107 @@
+/**
+ * \class Distribution
+ *
+ * \brief
+ *
+ * This class keeps streaming distributions of telemetry channels: time spent
+ * in every of DISTRIBUTION_BINS bins of channel range (time at rpm), time
+ * weighted mean, min/max and time beyond warning limit. A value holds until
+ * the next sample of its channel, time between samples further apart than
+ * DISTRIBUTION_GAP (no data) is not counted.
+ *
+ * Values are added in decode path, every sample updates one bin of lap and
+ * session scope (O(1)), nothing is allocated. Percentiles are interpolated
+ * from bins when shown, their resolution is range / DISTRIBUTION_BINS.
+ *
+ * Lap scope is reset when lap timer starts, session scope when it is reset
+ * from Statistics page.
+ *
+ * \version 1.0
+ *
+ * \date 2019/03/19 19:08:27
+ *
+ */
+#ifndef DISTRIBUTION_H
+#define DISTRIBUTION_H
+
+#include <QtGlobal>
+#include "../common/telemetry.h"
+#include "../common/limits.h"
+
+#define DISTRIBUTION_BINS       100         /* bins across channel range */
+#define DISTRIBUTION_GAP        1000000     /* [us] longer time between samples is not counted */
+
+enum DistributionScope {
+    SCOPE_LAP = 0,
+    SCOPE_SESSION,
+    SCOPE_COUNT
+};
+
+/* range of bins of channels, values out of range fall to the edge bins */
+static const float distributionRanges[CHANNEL_COUNT][2] = {
+    { 0, 6000 },        /* rpm */
+    { 0, 200 },         /* current [A] */
+    { 0, 110 },         /* voltage [V] */
+    { 0, 30 },          /* power [kW] */
+    { 0, 100 },         /* throttle [%] */
+    { 0, 120 },         /* controller temperature [C] */
+    { 0, 120 }          /* motor temperature [C] */
+};
+
+struct DistributionHistogram {
+    qint64 bins[DISTRIBUTION_BINS]; /// - time at values of bin [us]
+    qint64 time; /// - counted time [us]
+    qint64 beyond; /// - time beyond warning limit [us]
+    double sum; /// - sum of value * time (mean)
+    float min, max; /// - extremes of counted values
+    int count; /// - number of samples
+};
+
+class Distribution
+{
+public:
+    /**
+     * @brief Distribution - creates empty distributions of telemetry channels
+     */
+    Distribution();
+
+    /// adds value of channel decoded at time [us]
+    void add(int channel, float value, qint64 time);
+    /// counts time [us] of last value of channel again (skipped identical frame)
+    void hold(int channel, qint64 time);
+    /// sets warning limit of channel, time beyond it is counted
+    void setLimits(int channel, const ThresholdLimits &limits);
+    /// returns true if warning limit of channel is enabled
+    bool hasLimit(int channel) const;
+    /// clears scope, session reset clears lap too
+    void reset(int scope);
+    /// returns histogram of channel in scope
+    const DistributionHistogram &get(int channel, int scope) const;
+    /// returns time weighted mean of channel in scope, 0 if there is no sample
+    float getMean(int channel, int scope) const;
+    /// returns value below which channel spent percentile (0 - 100) of time in scope
+    float getPercentile(int channel, int scope, qreal percentile) const;
+    /// returns lowest value of bin of channel
+    float getBinValue(int channel, int bin) const;
+
+private:
+    struct Signal {
+        DistributionHistogram scopes[SCOPE_COUNT]; /// - lap and session
+        ThresholdLimits limits; /// - warning limit
+        float value; /// - last value
+        qint64 time; /// - time of last value [us], -1 if none
+    };
+
+    /// counts time from last value of channel to time [us]
+    void count(Signal &signal, int channel, qint64 time);
+    /// extends extremes of histogram by value
+    void extend(DistributionHistogram &histogram, float value);
+    /// returns bin of value of channel
+    int bin(int channel, float value) const;
+    /// clears histogram
+    void clear(DistributionHistogram &histogram);
+
+    Signal mSignals[CHANNEL_COUNT]; /// - distributions of telemetry channels
+};
+
+#endif // DISTRIBUTION_H
@@ -0,0 +1,327 @@
+#include <QtMath>
+#include "expression.h"
+#include "../common/telemetry.h"
+#include "../common/logger.h"
+
+#define CLASS_INFO          "expression"
+
+
+Expression::Expression()
+{
+    mPos = 0;
+    mDepth = 0;
+    mValid = false;
+}
+
+
+bool Expression::compile(const QString &source, QString &error)
+{
+    LOG (LOG_CONNECTIONS, "%s - compiling \"%s\"", CLASS_INFO, STR(source));
+
+    mSource = source;
+    mCode.clear();
+    mError.clear();
+    mPos = 0;
+    mDepth = 0;
+    mValid = false;
+
+    if (parseExpr() && mError.isEmpty()) {
+        skipSpaces();
+        if (mPos < mSource.length())
+            setError(QString("unexpected '%1' at %2").arg(mSource.at(mPos)).arg(mPos + 1));
+        else
+            mValid = true;
+    }
+
+    if (!mValid) {
+        mCode.clear();
+        error = mError;
+        LOG (LOG_CONNECTIONS, "%s - compilation failed - %s", CLASS_INFO, STR(mError));
+        return false;
+    }
+
+    mCode.squeeze();
+    LOG (LOG_CONNECTIONS, "%s - compiled to %d instructions", CLASS_INFO, mCode.size());
+
+    return true;
+}
+
+
+float Expression::evaluate(const float *values) const
+{
+    float stack[EXPR_MAX_STACK];
+    int sp = 0;
+
+    if (!mValid)
+        return 0;
+
+    const Instruction *ip = mCode.constData();
+    const Instruction *end = ip + mCode.size();
+
+    for (; ip != end; ++ip) {
+        switch (ip->op) {
+        case OP_CONST:
+            stack[sp++] = ip->value;
+            break;
+        case OP_LOAD:
+            stack[sp++] = values[ip->index];
+            break;
+        case OP_NEG:
+        case OP_ABS:
+            stack[sp - 1] = calculate(ip->op, stack[sp - 1], 0);
+            break;
+        default:
+            sp--;
+            stack[sp - 1] = calculate(ip->op, stack[sp - 1], stack[sp]);
+            break;
+        }
+    }
+
+    return stack[0];
+}
+
+
+bool Expression::isValid(void) const
+{
+    return mValid;
+}
+
+
+const QString &Expression::getSource(void) const
+{
+    return mSource;
+}
+
+
+bool Expression::parseExpr(void)
+{
+    if (!parseTerm())
+        return false;
+
+    for (;;) {
+        skipSpaces();
+        if (mPos >= mSource.length())
+            return true;
+
+        QChar c = mSource.at(mPos);
+        if (c != '+' && c != '-')
+            return true;
+
+        mPos++;
+        if (!parseTerm())
+            return false;
+        pushOp(c == '+' ? OP_ADD : OP_SUB);
+    }
+}
+
+
+bool Expression::parseTerm(void)
+{
+    if (!parseUnary())
+        return false;
+
+    for (;;) {
+        skipSpaces();
+        if (mPos >= mSource.length())
+            return true;
+
+        QChar c = mSource.at(mPos);
+        if (c != '*' && c != '/')
+            return true;
+
+        mPos++;
+        if (!parseUnary())
+            return false;
+        pushOp(c == '*' ? OP_MUL : OP_DIV);
+    }
+}
+
+
+bool Expression::parseUnary(void)
+{
+    skipSpaces();
+
+    if (mPos < mSource.length() && mSource.at(mPos) == '-') {
+        mPos++;
+        if (!parseUnary())
+            return false;
+        pushOp(OP_NEG);
+        return true;
+    }
+
+    return parsePrimary();
+}
+
+
+bool Expression::parsePrimary(void)
+{
+    skipSpaces();
+
+    if (mPos >= mSource.length())
+        return setError("unexpected end of expression");
+
+    QChar c = mSource.at(mPos);
+
+    /* parenthesis */
+    if (c == '(') {
+        mPos++;
+        if (!parseExpr())
+            return false;
+        skipSpaces();
+        if (mPos >= mSource.length() || mSource.at(mPos) != ')')
+            return setError(QString("missing ')' at %1").arg(mPos + 1));
+        mPos++;
+        return true;
+    }
+
+    /* number */
+    if (c.isDigit() || c == '.') {
+        int start = mPos;
+        while (mPos < mSource.length() && (mSource.at(mPos).isDigit() || mSource.at(mPos) == '.'))
+            mPos++;
+
+        bool valid;
+        float value = mSource.mid(start, mPos - start).toFloat(&valid);
+        if (!valid)
+            return setError(QString("wrong number at %1").arg(start + 1));
+        pushOp(OP_CONST, 0, value);
+        return true;
+    }
+
+    /* channel name or function */
+    if (c.isLetter() || c == '_') {
+        int start = mPos;
+        while (mPos < mSource.length() && (mSource.at(mPos).isLetterOrNumber() || mSource.at(mPos) == '_'))
+            mPos++;
+
+        QString name = mSource.mid(start, mPos - start);
+
+        skipSpaces();
+        if (mPos < mSource.length() && mSource.at(mPos) == '(')
+            return parseCall(name);
+
+        for (int i = 0; i < CHANNEL_COUNT; ++i) {
+            if (name == channelNames[i]) {
+                pushOp(OP_LOAD, i);
+                return true;
+            }
+        }
+        return setError(QString("unknown channel \"%1\"").arg(name));
+    }
+
+    return setError(QString("unexpected '%1' at %2").arg(c).arg(mPos + 1));
+}
+
+
+bool Expression::parseCall(const QString &name)
+{
+    quint8 op;
+    int args;
+
+    if (name == "abs") {
+        op = OP_ABS;
+        args = 1;
+    } else if (name == "min") {
+        op = OP_MIN;
+        args = 2;
+    } else if (name == "max") {
+        op = OP_MAX;
+        args = 2;
+    } else {
+        return setError(QString("unknown function \"%1\"").arg(name));
+    }
+
+    /* skip '(' */
+    mPos++;
+
+    for (int i = 0; i < args; ++i) {
+        if (i > 0) {
+            skipSpaces();
+            if (mPos >= mSource.length() || mSource.at(mPos) != ',')
+                return setError(QString("%1() needs %2 arguments").arg(name).arg(args));
+            mPos++;
+        }
+        if (!parseExpr())
+            return false;
+    }
+
+    skipSpaces();
+    if (mPos >= mSource.length() || mSource.at(mPos) != ')')
+        return setError(QString("missing ')' at %1").arg(mPos + 1));
+    mPos++;
+
+    pushOp(op);
+    return true;
+}
+
+
+void Expression::skipSpaces(void)
+{
+    while (mPos < mSource.length() && mSource.at(mPos).isSpace())
+        mPos++;
+}
+
+
+void Expression::pushOp(quint8 op, quint8 index, float value)
+{
+    int n = mCode.size();
+
+    switch (op) {
+    case OP_CONST:
+    case OP_LOAD:
+        mDepth++;
+        if (mDepth > EXPR_MAX_STACK) {
+            setError("expression too complex");
+            return;
+        }
+        break;
+    case OP_NEG:
+    case OP_ABS:
+        /* fold unary operation on constant */
+        if (n >= 1 && mCode[n - 1].op == OP_CONST) {
+            mCode[n - 1].value = calculate(op, mCode[n - 1].value, 0);
+            return;
+        }
+        break;
+    default:
+        mDepth--;
+        /* fold binary operation on two constants */
+        if (n >= 2 && mCode[n - 2].op == OP_CONST && mCode[n - 1].op == OP_CONST) {
+            mCode[n - 2].value = calculate(op, mCode[n - 2].value, mCode[n - 1].value);
+            mCode.removeLast();
+            return;
+        }
+        break;
+    }
+
+    Instruction instr;
+    instr.op = op;
+    instr.index = index;
+    instr.value = value;
+    mCode.append(instr);
+}
+
+
+float Expression::calculate(quint8 op, float a, float b)
+{
+    switch (op) {
+    case OP_ADD: return a + b;
+    case OP_SUB: return a - b;
+    case OP_MUL: return a * b;
+    case OP_DIV: return (b != 0) ? a / b : 0;
+    case OP_NEG: return -a;
+    case OP_ABS: return qAbs(a);
+    case OP_MIN: return qMin(a, b);
+    case OP_MAX: return qMax(a, b);
+    }
+    return 0;
+}
+
+
+bool Expression::setError(const QString &msg)
+{
+    if (mError.isEmpty())
+        mError = msg;
+
+    return false;
+}
@@ -0,0 +1,99 @@
+/**
+ * \class Expression
+ *
+ * \brief
+ *
+ * This class compiles computed channel expression (for example
+ * "power * 1000 / rpm") to a compact stack bytecode, which is evaluated
+ * for every decoded sample
+ *
+ * Grammar:
+ *      expr    := term (('+' | '-') term)*
+ *      term    := unary (('*' | '/') unary)*
+ *      unary   := '-' unary | primary
+ *      primary := number | channel | func '(' expr [',' expr] ')' | '(' expr ')'
+ *
+ * Channels are named as in channelNames (telemetry.h), functions are
+ * abs(x), min(a, b) and max(a, b). Division by zero gives 0.
+ *
+ * \version 1.0
+ *
+ * \date 2019/02/11 18:02:41
+ *
+ */
+#ifndef EXPRESSION_H
+#define EXPRESSION_H
+
+#include <QString>
+#include <QVector>
+
+#define EXPR_MAX_STACK          32
+
+class Expression
+{
+
+public:
+    Expression();
+
+    /**
+     * @brief compile - parses source and builds bytecode
+     * @param source - expression text
+     * @param error - filled with error description if compilation failed
+     * @return true if success
+     */
+    bool compile(const QString &source, QString &error);
+    /**
+     * @brief evaluate - runs bytecode
+     * @param values - array of CHANNEL_COUNT decoded values
+     * @return result of expression
+     */
+    float evaluate(const float *values) const;
+    /// returns true if expression was successfully compiled
+    bool isValid(void) const;
+    /// returns expression source text
+    const QString &getSource(void) const;
+
+private:
+    enum OpCode {
+        OP_CONST,
+        OP_LOAD,
+        OP_ADD,
+        OP_SUB,
+        OP_MUL,
+        OP_DIV,
+        OP_NEG,
+        OP_ABS,
+        OP_MIN,
+        OP_MAX
+    };
+
+    struct Instruction {
+        quint8 op; /// - operation code
+        quint8 index; /// - channel index (OP_LOAD)
+        float value; /// - constant value (OP_CONST)
+    };
+
+    /// parsing methods (recursive descent)
+    bool parseExpr(void);
+    bool parseTerm(void);
+    bool parseUnary(void);
+    bool parsePrimary(void);
+    bool parseCall(const QString &name);
+    /// skips white characters in source
+    void skipSpaces(void);
+    /// appends instruction to bytecode and folds constant operations
+    void pushOp(quint8 op, quint8 index = 0, float value = 0);
+    /// applies arithmetic operation (used by evaluation and constant folding)
+    static inline float calculate(quint8 op, float a, float b);
+    /// sets parser error
+    bool setError(const QString &msg);
+
+    QVector<Instruction> mCode; /// - compiled bytecode
+    QString mSource; /// - expression source text
+    QString mError; /// - last parser error
+    int mPos; /// - parser position in source
+    int mDepth; /// - current stack depth while compiling
+    bool mValid; /// - keeps information whether bytecode is ready
+};
+
+#endif // EXPRESSION_H
@@ -0,0 +1,281 @@
+#include <climits>
+#include "history.h"
+#include "../common/logger.h"
+
+#define CLASS_INFO          "history"
+
+
+History::History(int samples)
+{
+    LOG (LOG_CONNECTIONS, "%s - in constructor", CLASS_INFO);
+
+    mSamples = qMax(2, samples);
+    setInputs(CHANNEL_COUNT);
+}
+
+
+void History::setInputs(int count)
+{
+    LOG (LOG_CONNECTIONS, "%s - %d signals", CLASS_INFO, count);
+
+    count = qMax(int(CHANNEL_COUNT), count);
+
+    /* telemetry channels are kept, computed channels could be redefined */
+    mRings.resize(CHANNEL_COUNT);
+    mRings.resize(count);
+    for (int i = 0; i < count; ++i) {
+        if (mRings.at(i).samples.size() != mSamples)
+            reset(mRings[i]);
+    }
+}
+
+
+int History::getInputs(void) const
+{
+    return mRings.size();
+}
+
+
+void History::reset(Ring &ring)
+{
+    ring.samples.resize(mSamples);
+    ring.head = ring.count = 0;
+
+    for (int i = 0; i < HISTORY_LEVELS; ++i) {
+        Level &level = ring.levels[i];
+        level.buckets.resize(historyLevelSizes[i]);
+        level.head = level.count = 0;
+        level.open.count = 0;
+    }
+}
+
+
+void History::add(int input, float value, qint64 time)
+{
+    if (input < 0 || input >= mRings.size())
+        return;
+
+    Ring &ring = mRings[input];
+    HistorySample &sample = ring.samples[ring.head];
+
+    sample.time = time / 1000;
+    sample.value = value;
+    if (!ring.count)
+        ring.first = sample.time;
+    ring.head = (ring.head + 1) % mSamples;
+    if (ring.count < mSamples)
+        ring.count++;
+
+    HistoryBucket single = { sample.time, 1, value, value, value };
+    aggregate(ring, 0, single);
+}
+
+
+void History::repeat(int input, qint64 time)
+{
+    if (!getCount(input))
+        return;
+
+    const Ring &ring = mRings.at(input);
+    add(input, at(ring, ring.count - 1).value, time);
+}
+
+
+void History::aggregate(Ring &ring, int level, const HistoryBucket &value)
+{
+    Level &current = ring.levels[level];
+    qint32 start = value.time - value.time % historyLevelDurations[level];
+
+    /* value of next bucket closes the open one, it is stored and passed to coarser level */
+    if (current.open.count && current.open.time != start) {
+        current.buckets[current.head] = current.open;
+        current.head = (current.head + 1) % current.buckets.size();
+        if (current.count < current.buckets.size())
+            current.count++;
+
+        if (level + 1 < HISTORY_LEVELS)
+            aggregate(ring, level + 1, current.open);
+        current.open.count = 0;
+    }
+
+    current.open.merge(value);
+    current.open.time = start;
+}
+
+
+int History::getCount(int input) const
+{
+    if (input < 0 || input >= mRings.size())
+        return 0;
+
+    return mRings.at(input).count;
+}
+
+
+qint64 History::getLatest(int input) const
+{
+    if (!getCount(input))
+        return -1;
+
+    const Ring &ring = mRings.at(input);
+    return qint64(at(ring, ring.count - 1).time) * 1000;
+}
+
+
+qint64 History::getOldest(int input) const
+{
+    if (!getCount(input))
+        return -1;
+
+    const Ring &ring = mRings.at(input);
+    qint64 oldest = at(ring, 0).time;
+
+    for (int i = 0; i < HISTORY_LEVELS; ++i) {
+        if (ring.levels[i].count)
+            oldest = qMin(oldest, qint64(bucket(ring.levels[i], 0).time));
+    }
+
+    /* buckets are aligned to their duration, there is no data before the first sample */
+    return qMax(oldest, qint64(ring.first)) * 1000;
+}
+
+
+const HistorySample &History::at(const Ring &ring, int index) const
+{
+    return ring.samples.at((ring.head - ring.count + index + mSamples) % mSamples);
+}
+
+
+qint64 History::levelStart(const Level &level) const
+{
+    if (level.count)
+        return qint64(bucket(level, 0).time) * 1000;
+    if (level.open.count)
+        return qint64(level.open.time) * 1000;
+
+    return LLONG_MAX;
+}
+
+
+const HistoryBucket &History::bucket(const Level &level, int index) const
+{
+    int size = level.buckets.size();
+    return level.buckets.at((level.head - level.count + index + size) % size);
+}
+
+
+QVector<HistorySample> History::since(int input, qint64 after) const
+{
+    QVector<HistorySample> samples;
+
+    if (!getCount(input))
+        return samples;
+
+    const Ring &ring = mRings.at(input);
+
+    /* first sample newer than after (binary search, ring is in time order) */
+    int low = 0, high = ring.count;
+    while (low < high) {
+        int middle = (low + high) / 2;
+        if (qint64(at(ring, middle).time) * 1000 <= after)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+
+    samples.reserve(ring.count - low);
+    for (int i = low; i < ring.count; ++i)
+        samples.append(at(ring, i));
+
+    return samples;
+}
+
+
+QVector<HistoryBucket> History::query(int input, qint64 from, qint64 to, int columns) const
+{
+    QVector<HistoryBucket> result;
+
+    if (!getCount(input) || columns <= 0 || to <= from)
+        return result;
+
+    result.resize(columns);
+    for (int i = 0; i < columns; ++i) {
+        result[i].time = (from + (to - from) * i / columns) / 1000;
+        result[i].count = 0;
+    }
+
+    const Ring &ring = mRings.at(input);
+    qint64 column = (to - from) / columns;
+
+    /* window can start before the data, only data in range must be covered */
+    qint64 start = qMax(from, getOldest(input));
+
+    /* columns finer than finest level are made of raw samples if they reach back to start */
+    if (column < historyLevelDurations[0] * 1000LL && qint64(at(ring, 0).time) * 1000 <= start) {
+        int low = 0, high = ring.count;
+        while (low < high) {
+            int middle = (low + high) / 2;
+            if (qint64(at(ring, middle).time) * 1000 < from)
+                low = middle + 1;
+            else
+                high = middle;
+        }
+
+        for (int i = low; i < ring.count; ++i) {
+            const HistorySample &sample = at(ring, i);
+            qint64 time = qint64(sample.time) * 1000;
+            if (time >= to)
+                break;
+
+            HistoryBucket single = { sample.time, 1, sample.value, sample.value, sample.value };
+            result[(time - from) * columns / (to - from)].merge(single);
+        }
+
+        return result;
+    }
+
+    /* coarsest level finer than column, coarser one if it does not reach back to start */
+    int level = 0;
+    while (level + 1 < HISTORY_LEVELS && historyLevelDurations[level + 1] * 1000LL <= column)
+        level++;
+    while (level + 1 < HISTORY_LEVELS && levelStart(ring.levels[level]) > start)
+        level++;
+
+    const Level &chosen = ring.levels[level];
+    qint64 duration = historyLevelDurations[level] * 1000LL;
+
+    /* first closed bucket ending after from */
+    int low = 0, high = chosen.count;
+    while (low < high) {
+        int middle = (low + high) / 2;
+        if (qint64(bucket(chosen, middle).time) * 1000 + duration <= from)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+
+    for (int i = low; i < chosen.count; ++i) {
+        const HistoryBucket &closed = bucket(chosen, i);
+        qint64 time = qMax(qint64(closed.time) * 1000, from);
+        if (time >= to)
+            break;
+        result[(time - from) * columns / (to - from)].merge(closed);
+    }
+
+    /* newest values are in open buckets of chosen and finer levels */
+    for (int i = level; i >= 0; --i) {
+        const HistoryBucket &open = ring.levels[i].open;
+        qint64 time = qMax(qint64(open.time) * 1000, from);
+        if (open.count && time < to && qint64(open.time) * 1000 + historyLevelDurations[i] * 1000LL > from)
+            result[(time - from) * columns / (to - from)].merge(open);
+    }
+
+    return result;
+}
+
+
+void History::clear(void)
+{
+    for (int i = 0; i < mRings.size(); ++i)
+        reset(mRings[i]);
+}
@@ -0,0 +1,144 @@
+/**
+ * \class History
+ *
+ * \brief
+ *
+ * This class keeps always-on, fixed size rings of recent values of every
+ * decoded signal (telemetry channels followed by computed channels, the same
+ * indexes as render inputs). Values are added in decode path, one ring write
+ * per value, so a chart which is opened or switched to another signal shows
+ * the whole recent window at once.
+ *
+ * Sample is 8 bytes (time in ms of capture clock and value), rings of all
+ * signals are allocated once. Charts take samples with their decode times,
+ * value of skipped identical frame is repeated, so a missing sample means
+ * a gap in data.
+ *
+ * Every signal has also a pyramid of min/max/mean aggregates (1 s, 10 s,
+ * 60 s and 600 s buckets). A value updates open bucket of the finest level,
+ * closed bucket is merged to the next level, so append is O(1) amortized.
+ * query() picks the coarsest level which is still finer than a column, or
+ * a coarser one if it does not reach back far enough, its cost is
+ * proportional to the number of columns.
+ *
+ * Levels are sized by zoom ranges they serve: 1 s buckets cover the 10 min
+ * zoom (10.7 min), 10 s buckets the 1 h zoom (64 min), 60 s and 600 s buckets
+ * long sessions (4.3 h and 10.7 h). Memory per signal is 32 KB of samples
+ * and 26 KB of buckets (20 bytes), about 58 KB, so telemetry channels and
+ * a few computed channels take well under 1 MB.
+ *
+ * \version 1.0
+ *
+ * \date 2019/03/16 17:52:40
+ *
+ */
+#ifndef HISTORY_H
+#define HISTORY_H
+
+#include <QVector>
+#include "../common/telemetry.h"
+
+#define HISTORY_DEFAULT_SAMPLES     4096    /* samples kept per signal */
+#define HISTORY_LEVELS              4       /* aggregate levels */
+
+/* bucket duration [ms] and number of kept buckets of aggregate levels */
+static const qint32 historyLevelDurations[HISTORY_LEVELS] = { 1000, 10000, 60000, 600000 };
+static const int historyLevelSizes[HISTORY_LEVELS] = { 640, 384, 256, 64 };
+
+struct HistorySample {
+    qint32 time; /// - decode time [ms]
+    float value; /// - decoded value
+};
+
+struct HistoryBucket {
+    qint32 time; /// - start of bucket [ms]
+    qint32 count; /// - number of values, 0 if bucket is empty
+    float min, max, mean; /// - aggregates of values
+
+    /// adds aggregates of other bucket
+    void merge(const HistoryBucket &other)
+    {
+        if (!other.count)
+            return;
+        if (!count) {
+            min = other.min;
+            max = other.max;
+            mean = other.mean;
+            count = other.count;
+            return;
+        }
+        min = qMin(min, other.min);
+        max = qMax(max, other.max);
+        mean = (mean * count + other.mean * other.count) / (count + other.count);
+        count += other.count;
+    }
+};
+
+class History
+{
+public:
+    /**
+     * @brief History - creates rings of telemetry channels
+     * @param samples - samples kept per signal
+     */
+    explicit History(int samples = HISTORY_DEFAULT_SAMPLES);
+
+    /// sets number of signals (telemetry and computed channels), rings of computed channels are cleared
+    void setInputs(int count);
+    /// returns number of signals
+    int getInputs(void) const;
+    /// stores value of signal decoded at time [us]
+    void add(int input, float value, qint64 time);
+    /// stores newest value of signal again at time [us] (skipped identical frame)
+    void repeat(int input, qint64 time);
+    /// returns number of kept samples of signal
+    int getCount(int input) const;
+    /// returns time of newest sample of signal [us], -1 if there is none
+    qint64 getLatest(int input) const;
+    /// returns time of oldest kept value of signal (raw or aggregated) [us], -1 if there is none
+    qint64 getOldest(int input) const;
+    /// returns kept samples of signal newer than after [us], oldest first
+    QVector<HistorySample> since(int input, qint64 after) const;
+    /**
+     * @brief query - returns min/max/mean of columns of time range, columns without
+     * data have zero count
+     * @param input - signal
+     * @param from, to - time range [us]
+     * @param columns - number of columns (pixels)
+     */
+    QVector<HistoryBucket> query(int input, qint64 from, qint64 to, int columns) const;
+    /// removes all samples
+    void clear(void);
+
+private:
+    struct Level {
+        QVector<HistoryBucket> buckets; /// - ring of closed buckets
+        int head; /// - next write position
+        int count; /// - number of stored buckets
+        HistoryBucket open; /// - bucket being filled
+    };
+
+    struct Ring {
+        QVector<HistorySample> samples; /// - ring of samples
+        int head; /// - next write position
+        int count; /// - number of stored samples
+        qint32 first; /// - time of first sample since reset [ms]
+        Level levels[HISTORY_LEVELS]; /// - aggregates
+    };
+
+    /// returns sample of ring in time order (0 - oldest)
+    const HistorySample &at(const Ring &ring, int index) const;
+    /// returns start of oldest bucket of level (closed or open) [us], LLONG_MAX if level is empty
+    qint64 levelStart(const Level &level) const;
+    /// returns closed bucket of level in time order (0 - oldest)
+    const HistoryBucket &bucket(const Level &level, int index) const;
+    /// adds bucket (single value or closed bucket of finer level) to level of ring
+    void aggregate(Ring &ring, int level, const HistoryBucket &value);
+    /// clears ring and its levels
+    void reset(Ring &ring);
+
+    QVector<Ring> mRings; /// - ring of every signal
+    int mSamples; /// - capacity of ring
+};
+
+#endif // HISTORY_H
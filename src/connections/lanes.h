@@ -0,0 +1,51 @@
+#ifndef LANES
+#define LANES
+
+#include <QtGlobal>
+
+/* priority lanes of decoded data:
+ *  LANE_ALERTS    - alert transitions, delivered as soon as frame is decoded
+ *  LANE_TELEMETRY - values, coalesced (only latest value is delivered)
+ */
+enum Lane {
+    LANE_ALERTS = 0,
+    LANE_TELEMETRY,
+    LANE_COUNT
+};
+
+static const char * const laneNames[LANE_COUNT] = {
+    "alerts",
+    "telemetry"
+};
+
+/* delivery statistics of lane, latency is measured from frame receive
+ * time to the moment when all receivers got the value [us] */
+struct LaneStats {
+    quint64 delivered; /// - number of delivered updates
+    quint64 coalesced; /// - number of updates replaced by newer value before delivery
+    qint64 totalLatency; /// - sum of latencies
+    qint64 maxLatency; /// - worst latency
+
+    LaneStats() { reset(); }
+
+    void reset(void)
+    {
+        delivered = coalesced = 0;
+        totalLatency = maxLatency = 0;
+    }
+
+    void add(qint64 latency)
+    {
+        delivered++;
+        totalLatency += latency;
+        if (latency > maxLatency)
+            maxLatency = latency;
+    }
+
+    double meanLatency(void) const
+    {
+        return delivered ? double(totalLatency) / delivered : 0;
+    }
+};
+
+#endif // LANES
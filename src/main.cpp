@@ -5,20 +5,23 @@
 
 #include "main/mainwindow.h"
 #include "common/logger.h"
+#include "common/pipeline.h"
 #include "main/rpmwidget.h"
 
 #define     BUF_LEN         255
 #define     EXIT_FAILURE    1
 int gLogMask;
+StageCounter gStages[STAGE_COUNT];
 
 int main(int argc, char *argv[])
 {
     int opt;
+    bool overlay = false;
 
-    while ((opt = getopt(argc, argv, "hl:")) != -1) {
+    while ((opt = getopt(argc, argv, "hol:")) != -1) {
         switch (opt) {
         case 'h':
-            qDebug() << "Usage: \n\t" << "-h\t  - help \n\t" \
+            qDebug() << "Usage: \n\t" << "-h\t  - help \n\t" << "-o\t  - performance overlay \n\t" \
                      << "-l <arg> - debug level \n\t\t" << "LOG_MAIN \t\t 0x0001\n\t\t" \
                      << "LOG_GUI \t\t 0x0002\n\t\t" << "LOG_CONNECTIONS \t 0x0004\n\t\t" \
                      << "LOG_RPM \t\t 0x0008\n\t\t" << "LOG_MAINWINDOW \t 0x0010\n\t\t" \
@@ -27,6 +30,9 @@ int main(int argc, char *argv[])
                      << "LOG_MAINWINDOW_DATA \t 0x0200\n\t\t" << "LOG_STATS \t\t 0x0400\n";
             exit(EXIT_FAILURE);
             break;
+        case 'o':
+            overlay = true;
+            break;
         case 'l':
             sscanf(optarg, "%x", &gLogMask);
             LOG (LOG_MAIN, "Logger mask - [0x%04x]\n", gLogMask);
@@ -40,6 +46,8 @@ int main(int argc, char *argv[])
     QApplication a(argc, argv);
     a.setWindowIcon(QIcon(":/44x44/44x44/navigation.png"));
     MainWindow w;
+    if (overlay)
+        w.getPerfOverlay()->setPinned(true);
     w.show();
     return a.exec();
 }
@@ -7,6 +7,8 @@
 #include "ui_mainwindow.h"
 #include "../common/parameters.h"
 #include "../common/logger.h"
+#include "../common/pipeline.h"
+#include "../alerts/ledindicator.h"
 #include "../settings/parser.h"
 
 
@@ -25,6 +27,10 @@ MainWindow::MainWindow(QWidget *parent)
     this->centerOnScreen();
     lastButtonObject = NULL;
     lapTimerStarted = false;
+    interpolation = true;
+
+    /* create theme (background contrast and font of whole window) */
+    theme = new Theme(ui->centralwidget, this);
 
     /* create rpm widget */
     rpm = new RpmWidget(ui->rpm_widget);
@@ -38,8 +44,21 @@ MainWindow::MainWindow(QWidget *parent)
     /* create settings widget */
     settings = new Settings(ui->settingsWidget, connection);
 
+    /* create render clock (widgets are repainted at display rate) */
+    render = new RenderScheduler(this);
+
     /* create statistics widget */
-    stats = new Statistics(ui->statsWidget, connection);
+    stats = new Statistics(ui->statsWidget, connection, render);
+
+    /* create performance overlay (hidden until enabled) */
+    perfOverlay = new PerfOverlay(this, connection, render);
+
+    /* create overload controller (sheds optional work when GUI falls behind) */
+    overload = new OverloadController(connection, this);
+    connect (overload, &OverloadController::levelChanged,
+                this, &MainWindow::applyLoadLevel);
+    connect (overload, &OverloadController::printMessage,
+                settings, &Settings::consolePrintExternalMessage);
 
     /* set connection status */
     connection->setConnectionStatus(false);
@@ -48,10 +67,10 @@ MainWindow::MainWindow(QWidget *parent)
     setStateConnectionButton(connection->getConnectionStatus());
 
     /* set buttons map */
-    map["vfMain"] = 0;
-    map["vfAlerts"] = 1;
-    map["vfStats"] = 2;
-    map["vfSettings"] = 3;
+    map["vfMain"] = PAGE_DRIVE;
+    map["vfAlerts"] = PAGE_ALERTS;
+    map["vfStats"] = PAGE_STATS;
+    map["vfSettings"] = PAGE_SETTINGS;
 
     /* initialize functions buttons */
     initializeFunctionButtons();
@@ -69,14 +88,17 @@ MainWindow::MainWindow(QWidget *parent)
     /* initializing flashing button timer */
     initializeFlashTimer();
 
+    /* bind panel widgets to warning thresholds */
+    initializeThresholds();
+
     /* set start page */
     menuButtonChanged(*ui->vfMain);
 
     /* set default alert status */
     updateAlertsStatus(-1);
 
-    /* enable data refreshing */
-    enableDataRefreshing();
+    /* register consumers of data (once, live only on their page) */
+    initializeSubscriptions();
 
     /* read config file */
     conf_exit();
@@ -110,6 +132,18 @@ MainWindow::~MainWindow()
 }
 
 
+Connections *MainWindow::getConnection(void)
+{
+    return connection;
+}
+
+
+PerfOverlay *MainWindow::getPerfOverlay(void)
+{
+    return perfOverlay;
+}
+
+
 void MainWindow::centerOnScreen(void)
 {
    LOG (LOG_MAINWINDOW, "%s - centering on screen", CLASS_INFO);
@@ -125,14 +159,8 @@ void MainWindow::initializeFunctionButtons(void)
 
     connect (ui->driveButton, &QPushButton::clicked,
                 [this] { menuButtonChanged(*ui->vfMain); });
-    connect (ui->driveButton, &QPushButton::clicked,
-                this, &MainWindow::enableDataRefreshing);
     connect (ui->alertsButton, &QPushButton::clicked,
                 [this] { menuButtonChanged(*ui->vfAlerts); });
-    connect (ui->statsButton, &QPushButton::clicked,
-                stats, &Statistics::enableChartData);
-    connect (this, &MainWindow::statsMenuDisabled,
-                stats, &Statistics::disableChartData);
     connect (ui->statsButton, &QPushButton::clicked,
                 [this] { menuButtonChanged(*ui->vfStats); });
     connect (ui->settingsButton, &QPushButton::clicked,
@@ -153,6 +181,9 @@ void MainWindow::initializeSignalsAndSlots(void)
     connect (settings, &Settings::updateFontSize,
                 [=] (QString size) { updateFontSize(size); });
 
+    connect (settings, &Settings::updateLimits,
+                this, &MainWindow::updateLimits);
+
     connect (settings, &Settings::quitApplication,
                 [this] () { this->close(); });
 
@@ -161,6 +192,53 @@ void MainWindow::initializeSignalsAndSlots(void)
 
     connect (settings, &Settings::rebootSystem,
                 this, &MainWindow::rebootSystem);
+
+    /* decoded values only update render clock inputs */
+    connect (connection, &Connections::updateRpmSpeed, render,
+                [=] (quint16 value) { render->setValue(CHANNEL_RPM, value); });
+    connect (connection, &Connections::updateBatteryCurrent, render,
+                [=] (quint16 value) { render->setValue(CHANNEL_CURRENT, value); });
+    connect (connection, &Connections::updateBatteryVoltage, render,
+                [=] (quint16 value) { render->setValue(CHANNEL_VOLTAGE, value); });
+    connect (connection, &Connections::updatePower, render,
+                [=] (float value) { render->setValue(CHANNEL_POWER, value); });
+    connect (connection, &Connections::updateThrottle, render,
+                [=] (quint16 value) { render->setValue(CHANNEL_THROTTLE, value); });
+    connect (connection, &Connections::updateControllerTemp, render,
+                [=] (quint16 value) { render->setValue(CHANNEL_CONTR_TEMP, value); });
+    connect (connection, &Connections::updateMotorTemp, render,
+                [=] (quint16 value) { render->setValue(CHANNEL_MOTOR_TEMP, value); });
+    connect (connection, &Connections::updateComputedChannel, render,
+                [=] (int index, float value) { render->setValue(RENDER_COMPUTED + index, value); });
+
+    /* continuous targets (charts) run only while data is flowing */
+    connect (connection, &Connections::setConnectionStateButton, render,
+                [=] (bool isConnected) {
+                    render->setActive(isConnected);
+                    if (!isConnected)
+                        render->printStats();
+                });
+
+    connect (render, &RenderScheduler::printMessage,
+                settings, &Settings::consolePrintExternalMessage);
+
+    connect (settings, &Settings::updateRenderRate,
+                render, &RenderScheduler::setRate);
+
+    connect (settings, &Settings::updateInterpolation,
+                this, &MainWindow::setInterpolation);
+
+    connect (settings, &Settings::updateExtrapolation,
+                rpm, &RpmWidget::setExtrapolation);
+
+    connect (settings, &Settings::updateOverlay,
+                perfOverlay, &PerfOverlay::setRequested);
+
+    connect (settings, &Settings::updatePartialRepaint,
+                this, &MainWindow::setPartialRepaint);
+
+    connect (settings, &Settings::updateChartWindow,
+                stats, &Statistics::setChartWindow);
 }
 
 
@@ -185,6 +263,58 @@ void MainWindow::initializeLapTimer(void)
 }
 
 
+void MainWindow::initializeThresholds(void)
+{
+    LOG (LOG_MAINWINDOW, "%s - initializing thresholds", CLASS_INFO);
+
+    thresholds[CHANNEL_CURRENT].addWidget(ui->batteryCurrent);
+    thresholds[CHANNEL_CURRENT].addWidget(ui->batteryCurrentLcd);
+    thresholds[CHANNEL_VOLTAGE].addWidget(ui->batteryVoltage);
+    thresholds[CHANNEL_VOLTAGE].addWidget(ui->batteryVoltageLcd);
+    thresholds[CHANNEL_POWER].addWidget(ui->avrPower);
+    thresholds[CHANNEL_POWER].addWidget(ui->avrPowerLcd);
+    thresholds[CHANNEL_THROTTLE].addWidget(ui->throttle);
+    thresholds[CHANNEL_THROTTLE].addWidget(ui->throttleLcd);
+    thresholds[CHANNEL_CONTR_TEMP].addWidget(ui->contrTemp);
+    thresholds[CHANNEL_CONTR_TEMP].addWidget(ui->contrTempLcd);
+    thresholds[CHANNEL_MOTOR_TEMP].addWidget(ui->motorTemp);
+    thresholds[CHANNEL_MOTOR_TEMP].addWidget(ui->motorTempLcd);
+
+    for (int i = 0; i < CHANNEL_COUNT; ++i)
+        thresholds[i].setLimits(defaultLimits[i]);
+}
+
+
+void MainWindow::updateLimits(int channel, float warning, float alarm, float hysteresis)
+{
+    LOG (LOG_MAINWINDOW, "%s - %s limits changed", CLASS_INFO, channelNames[channel]);
+
+    ThresholdLimits limits;
+    limits.warning = warning;
+    limits.alarm = alarm;
+    limits.hysteresis = hysteresis;
+    thresholds[channel].setLimits(limits);
+    connection->getDistribution()->setLimits(channel, limits);
+}
+
+
+void MainWindow::setPartialRepaint(bool enable)
+{
+    LOG (LOG_MAINWINDOW, "%s - partial repaint %s", CLASS_INFO, enable ? "enabled" : "disabled");
+
+    /* elements invalidate only what they draw and are opaque where they paint background */
+    QList<SegmentDisplay *> displays = findChildren<SegmentDisplay *>();
+    for (int i = 0; i < displays.size(); ++i)
+        displays.at(i)->setPartialRepaint(enable);
+
+    QList<LedIndicator *> leds = findChildren<LedIndicator *>();
+    for (int i = 0; i < leds.size(); ++i)
+        leds.at(i)->setPartialRepaint(enable);
+
+    rpm->setPartialRepaint(enable);
+}
+
+
 void MainWindow::initializeFlashTimer(void)
 {
     flashTimer = new QTimer();
@@ -215,16 +345,6 @@ void MainWindow::menuButtonChanged(QFrame &frame)
         buttonStyleUpdate(frame, true);
         LOG (LOG_MAINWINDOW, "%s - changed page to %d", CLASS_INFO, map[frame.objectName()]);
     } else if (lastButtonObject != &frame) {
-        switch (map[lastButtonObject->objectName()])
-        {
-            case 0:
-                disableDataRefreshing();
-                break;
-            case 2:
-                emit statsMenuDisabled();
-                break;
-        }
-
         if (!QString::compare(flashingObject, frame.objectName())) {
             setButtonFlashing(frame, false);
         }
@@ -237,50 +357,63 @@ void MainWindow::menuButtonChanged(QFrame &frame)
 }
 
 
-void MainWindow::enableDataRefreshing(void)
+void MainWindow::initializeSubscriptions(void)
 {
-    LOG (LOG_MAINWINDOW, "%s - enabled main window data refreshing", CLASS_INFO);
+    LOG (LOG_MAINWINDOW, "%s - initializing data subscriptions", CLASS_INFO);
 
-    connect (connection, &Connections::updateRpmSpeed, rpm,
-                [=] (quint16 speed) { rpm->updateWidget(speed); });
+    connect (connection, &Connections::setConnectionStateButton,
+                this, &MainWindow::setStateConnectionButton);
 
-    connect (connection, &Connections::setConnectionStateButton, this,
-                [=] (bool isConnected) { setStateConnectionButton(isConnected); });
+    /* values of drive page are rendered by render clock only while page is visible */
+    render->addTarget(this, CHANNEL_RPM,
+                [=] (float speed) { rpm->addSample(speed, render->getSampleTime(CHANNEL_RPM)); },
+                false, PAGE_DRIVE);
+    render->addTarget(this, CHANNEL_RPM,
+                [=] (float) { rpm->advance(render->getFrameTime()); }, true, PAGE_DRIVE);
+    render->addTarget(this, CHANNEL_CURRENT,
+                [=] (float current) { updateBatteryCurrent(current); }, false, PAGE_DRIVE);
+    render->addTarget(this, CHANNEL_VOLTAGE,
+                [=] (float voltage) { updateBatteryVoltage(voltage); }, false, PAGE_DRIVE);
+    render->addTarget(this, CHANNEL_POWER,
+                [=] (float power) { updatePower(power); }, false, PAGE_DRIVE);
+    render->addTarget(this, CHANNEL_THROTTLE,
+                [=] (float throttle) { updateThrottle(throttle); }, false, PAGE_DRIVE);
+    render->addTarget(this, CHANNEL_CONTR_TEMP,
+                [=] (float temp) { updateControllerTemp(temp); }, false, PAGE_DRIVE);
+    render->addTarget(this, CHANNEL_MOTOR_TEMP,
+                [=] (float temp) { updateMotorTemp(temp); }, false, PAGE_DRIVE);
 
-    connect (connection, &Connections::updateBatteryCurrent, this,
-                [=] (quint16 current) { updateBatteryCurrent(current); });
+    connect (ui->stackedWidget, &QStackedWidget::currentChanged,
+                render, &RenderScheduler::setPage);
+    render->setPage(ui->stackedWidget->currentIndex());
 
-    connect (connection, &Connections::updateBatteryVoltage, this,
-                [=] (quint16 voltage) { updateBatteryVoltage(voltage); });
-
-    connect (connection, &Connections::updatePower, this,
-                [=] (float power) { updatePower(power); });
-
-    connect (connection, &Connections::updateThrottle, this,
-                [=] (quint16 throttle) { updateThrottle(throttle); });
+    /* alert status is shown in menu, it is refreshed on every page */
+    connect (alerts, &Alerts::setAlertsButtonState,
+                this, &MainWindow::updateAlertsStatus);
 
-    connect (connection, &Connections::updateControllerTemp, this,
-                [=] (quint16 temp) { updateControllerTemp(temp); });
+    connect (connection, &Connections::setAlertsButtonState,
+                this, &MainWindow::updateAlertsStatus);
+}
 
-    connect (connection, &Connections::updateMotorTemp, this,
-                [=] (quint16 temp) { updateMotorTemp(temp); });
 
-    connect (alerts, &Alerts::setAlertsButtonState,
-                [=] (int errors) { updateAlertsStatus(errors); });
+void MainWindow::applyLoadLevel(int level)
+{
+    LOG (LOG_MAINWINDOW, "%s - load level %d", CLASS_INFO, level);
 
-    connect (connection, &Connections::setAlertsButtonState, this,
-                [=] (int state) { updateAlertsStatus(state); });
+    stats->setLoadLevel(level);
+    connection->setCanEchoShed(level >= LOAD_CAN_ECHO);
+    rpm->setSmoothing(level < LOAD_NEEDLE_SMOOTHING);
+    /* interpolation and extrapolation at display rate are the cost of smoothing */
+    rpm->setInterpolation(interpolation && level < LOAD_NEEDLE_SMOOTHING);
 }
 
 
-void MainWindow::disableDataRefreshing(void)
+void MainWindow::setInterpolation(bool enable)
 {
-    LOG (LOG_MAINWINDOW, "%s - disabled main window data refreshing", CLASS_INFO);
-
-    disconnect(connection, 0, this, 0);
-    disconnect(connection, &Connections::updateRpmSpeed, rpm, 0);
-    disconnect(alerts, 0, this, 0);
+    LOG (LOG_MAINWINDOW, "%s - rpm interpolation %s", CLASS_INFO, enable ? "enabled" : "disabled");
 
+    interpolation = enable;
+    rpm->setInterpolation(interpolation && overload->getLevel() < LOAD_NEEDLE_SMOOTHING);
 }
 
 
@@ -326,17 +459,14 @@ template <typename T> void MainWindow::styleUpdate(T *widget, const char* proper
 }
 
 
-template <typename T> void MainWindow::lcdStyleUpdate(T &widget, quint16 value, quint16 limit, quint16 max, bool isChanged)
+bool MainWindow::lcdDisplay(SegmentDisplay *lcd, double value)
 {
-    if (value > max)
-        styleUpdate(widget, "warning2", isChanged);
-    else if (value > limit) {
-        styleUpdate(widget, "warning", isChanged);
-        styleUpdate(widget, "warning2", !isChanged);
-    } else {
-        styleUpdate(widget, "warning", !isChanged);
-        styleUpdate(widget, "warning2", !isChanged);
-    }
+    /* displayed value has not changed, skip repainting and restyling */
+    if (!stageCount(STAGE_RENDER, lcd->value() != value))
+        return false;
+
+    lcd->display(value);
+    return true;
 }
 
 
@@ -344,9 +474,9 @@ void MainWindow::updateBatteryCurrent(quint16 current)
 {
     LOG (LOG_MAINWINDOW_DATA, "%s - battery current - %d [A]", CLASS_INFO, current);
 
-    ui->batteryCurrentLcd->display(current);
-    lcdStyleUpdate(ui->batteryCurrent, current, 80, 140, true);
-    lcdStyleUpdate(ui->batteryCurrentLcd, current, 80, 140, true);
+    if (!lcdDisplay(ui->batteryCurrentLcd, current))
+        return;
+    thresholds[CHANNEL_CURRENT].update(current);
 }
 
 
@@ -354,9 +484,9 @@ void MainWindow::updateBatteryVoltage(quint16 voltage)
 {
     LOG (LOG_MAINWINDOW_DATA, "%s - battery voltage - %d [V]", CLASS_INFO, voltage);
 
-    ui->batteryVoltageLcd->display(voltage);
-    lcdStyleUpdate(ui->batteryVoltage, voltage, 84, 74, false); /* TODO not working properly */
-    lcdStyleUpdate(ui->batteryVoltageLcd, voltage, 84, 74, false);
+    if (!lcdDisplay(ui->batteryVoltageLcd, voltage))
+        return;
+    thresholds[CHANNEL_VOLTAGE].update(voltage);
 }
 
 
@@ -364,9 +494,9 @@ void MainWindow::updatePower(float power)
 {
     LOG (LOG_MAINWINDOW_DATA, "%s - battery power - %d [W]", CLASS_INFO, power);
 
-    ui->avrPowerLcd->display(power);
-    lcdStyleUpdate(ui->avrPower, power, 8, 20, true);
-    lcdStyleUpdate(ui->avrPowerLcd, power, 8, 20, true);
+    if (!lcdDisplay(ui->avrPowerLcd, power))
+        return;
+    thresholds[CHANNEL_POWER].update(power);
 }
 
 
@@ -374,7 +504,9 @@ void MainWindow::updateThrottle(quint16 throttle)
 {
     LOG (LOG_MAINWINDOW_DATA, "%s - throttle - %d [%]", CLASS_INFO, throttle);
 
-    ui->throttleLcd->display(throttle);
+    if (!lcdDisplay(ui->throttleLcd, throttle))
+        return;
+    thresholds[CHANNEL_THROTTLE].update(throttle);
 }
 
 
@@ -382,9 +514,9 @@ void MainWindow::updateControllerTemp(quint16 temp)
 {
     LOG (LOG_MAINWINDOW_DATA, "%s - controller temperature - %d [C]", CLASS_INFO, temp);
 
-    ui->contrTempLcd->display(temp);
-    lcdStyleUpdate(ui->contrTemp, temp, 45, 65, true);
-    lcdStyleUpdate(ui->contrTempLcd, temp, 45, 65, true);
+    if (!lcdDisplay(ui->contrTempLcd, temp))
+        return;
+    thresholds[CHANNEL_CONTR_TEMP].update(temp);
 }
 
 
@@ -392,9 +524,9 @@ void MainWindow::updateMotorTemp(quint16 temp)
 {
     LOG (LOG_MAINWINDOW_DATA, "%s - motor temperature - %d [C]", CLASS_INFO, temp);
 
-    ui->motorTempLcd->display(temp);
-    lcdStyleUpdate(ui->motorTemp, temp, 50, 65, true);
-    lcdStyleUpdate(ui->motorTempLcd, temp, 50, 65, true);
+    if (!lcdDisplay(ui->motorTempLcd, temp))
+        return;
+    thresholds[CHANNEL_MOTOR_TEMP].update(temp);
 }
 
 
@@ -403,11 +535,7 @@ void MainWindow::updateBackgroundContrast(int value)
     LOG (LOG_MAINWINDOW_DATA, "%s - background contrast changed to (%d,%d,%d)", CLASS_INFO,
             value, value, value);
 
-    QString style = "background-color: rgb(%1, %2, %3);";
-    ui->centralwidget->setStyleSheet(style.arg(value).arg(value).arg(value));
-    ui->gridFrame->setStyleSheet(style.arg(value).arg(value).arg(value));
-    ui->stackedWidget->setStyleSheet(style.arg(value).arg(value).arg(value));
-    ui->menuButtonsGroup->setStyleSheet(style.arg(value).arg(value).arg(value));
+    theme->setContrast(value);
 }
 
 
@@ -416,11 +544,7 @@ void MainWindow::updateFontSize(QString size)
     LOG (LOG_MAINWINDOW_DATA, "%s - font size changed to - %s", CLASS_INFO,
             size.toStdString().c_str());
 
-    QString style = "font: italic bold %1pt";
-    ui->centralwidget->setStyleSheet(style.arg(size));
-    ui->gridFrame->setStyleSheet(style.arg(size));
-    ui->stackedWidget->setStyleSheet(style.arg(size));
-    ui->menuButtonsGroup->setStyleSheet(style.arg(size));
+    theme->setFontSize(size.toInt());
 }
 
 /* 0x0 - no alerts
@@ -535,6 +659,8 @@ void MainWindow::startLapTimerSlot(void)
     LOG (LOG_MAINWINDOW, "%s - lap timer started", CLASS_INFO);
 
     if (!lapTimerStarted) {
+        /* lap distributions start with lap */
+        connection->getDistribution()->reset(SCOPE_LAP);
         lapTimerStarted = true;
         styleUpdate(ui->timerButton, "clicked", true);
         ui->timerButton->setText("Stop Timer");
@@ -29,6 +29,12 @@
 #include <QString>
 #include <QTimer>
 #include "rpmwidget.h"
+#include "overload.h"
+#include "renderscheduler.h"
+#include "threshold.h"
+#include "theme.h"
+#include "perfoverlay.h"
+#include "segmentdisplay.h"
 #include "../connections/connections.h"
 #include "../alerts/alerts.h"
 #include "../settings/settings.h"
@@ -48,14 +54,18 @@ public:
     MainWindow(QWidget *parent = 0);
     /// destructs a MainWindow
     ~MainWindow();
+    /// returns pointer to Connections class (benchmarks)
+    Connections *getConnection(void);
+    /// returns pointer to PerfOverlay class (command line)
+    PerfOverlay *getPerfOverlay(void);
 
 signals:
     /// signal emitted when timer stopped
     void addLapTime(QString);
 
 private:
-    /// This method is used to change property of panel LCD objects in MainWindow
-    template <typename T> void lcdStyleUpdate(T &widget, quint16 value, quint16 limit, quint16 max, bool isChanged);
+    /// This method displays value on LCD, returns false if displayed value has not changed
+    bool lcdDisplay(SegmentDisplay *lcd, double value);
     /// This method updates style of type T widget
     template <typename T> void styleUpdate(T *widget, const char* property, bool isChanged);
     /// This method is used to find childs of menu buttons panel
@@ -68,6 +78,10 @@ private:
     void initializeSignalsAndSlots(void);
     /// This method is used to create QTimer objects needed for lap timer tool
     void initializeLapTimer(void);
+    /// This method binds panel frames and LCDs to warning thresholds
+    void initializeThresholds(void);
+    /// This method registers consumers of data once, render targets are bound to their page
+    void initializeSubscriptions(void);
     /// This method is used to create QTimer object for flash timer
     void initializeFlashTimer(void);
     /// In this method we create new QTimer object and set timeout
@@ -80,11 +94,10 @@ private:
     void setLapTimerTime(void);
     /// This method is called to set flashing button
     void setButtonFlashing(QFrame &frame, bool start);
-    /// Method called to froze mainwindow data
-    void disableDataRefreshing(void);
 
 
     bool lapTimerStarted; /// keeps information whether lap timer has started or not
+    bool interpolation; /// keeps rpm interpolation set in Settings (restored when load drops)
     bool setFlash; /// keeps information whether timer for flashing button started
     int s, m, ms; /// keeps information about lap (minutes, seconds, miliseconds)
     QMap<QString, int> map; /// mapper for menu buttons page index (for example main: 0, settings: 1)
@@ -99,6 +112,11 @@ private:
     Connections *connection; /// pointer to Connections class
     RpmWidget *rpm; /// pointer to RpmWidget class
     Statistics *stats; /// pointer to Statistics class
+    OverloadController *overload; /// pointer to OverloadController class
+    RenderScheduler *render; /// pointer to RenderScheduler class
+    Threshold thresholds[CHANNEL_COUNT]; /// warning states of panel values
+    Theme *theme; /// pointer to Theme class
+    PerfOverlay *perfOverlay; /// pointer to PerfOverlay class
 
 public slots:
     /// This method is called when connection is established or closed
@@ -121,6 +139,12 @@ public slots:
     void updateBackgroundContrast(int value);
     /// This method is called when font size has changed in Settings class
     void updateFontSize(QString size);
+    /// This method is called when warning limits of channel have changed in Settings class
+    void updateLimits(int channel, float warning, float alarm, float hysteresis);
+    /// This method enables/disables partial repaint mode of dashboard widgets (framebuffer)
+    void setPartialRepaint(bool enable);
+    /// This method enables/disables rpm interpolation set in Settings class (kept off while shed)
+    void setInterpolation(bool enable);
 
 private slots:
     /// This method is called when time has changed
@@ -133,12 +157,9 @@ private slots:
     void resetLapTimerSlot(void);
     /// Method called to shutdown system
     void shutdownSystem(void);
-    /// Method called to enable main window data refreshing
-    void enableDataRefreshing(void);
+    /// Method called when load level changed (sheds or restores optional work)
+    void applyLoadLevel(int level);
     void rebootSystem(void);
-
-signals:
-    void statsMenuDisabled();
 };
 
 #endif // MAINWINDOW_H
@@ -0,0 +1,101 @@
+#include "overload.h"
+#include "../common/logger.h"
+
+#define CLASS_INFO          "overload"
+#define LAG_SMOOTHING       0.3
+
+static const char * const levelNames[LOAD_LEVELS] = {
+    "full quality",
+    "reduced chart refresh rate",
+    "chart antialiasing disabled",
+    "CAN console echo disabled",
+    "needle smoothing disabled"
+};
+
+
+OverloadController::OverloadController(Connections *connection, QObject *parent)
+    : QObject(parent)
+{
+    LOG (LOG_MAIN, "%s - in constructor", CLASS_INFO);
+
+    con = connection;
+    mLag = 0;
+    mLevel = LOAD_FULL;
+    mHigh = mLow = 0;
+    mShed = mRestored = 0;
+
+    connect (&mTimer, &QTimer::timeout, this, &OverloadController::probe);
+    mTimer.start(OVERLOAD_PROBE_MS);
+    mClock.start();
+}
+
+
+OverloadController::~OverloadController()
+{
+    LOG (LOG_MAIN, "%s - in destructor, shed %llu, restored %llu", CLASS_INFO,
+         mShed, mRestored);
+}
+
+
+void OverloadController::probe(void)
+{
+    /* timer fired late by the time event loop was busy */
+    qint64 lag = qMax(qint64(0), mClock.restart() - OVERLOAD_PROBE_MS);
+    qint64 backlog = con->getBacklog();
+
+    mLag = mLag * (1 - LAG_SMOOTHING) + lag * LAG_SMOOTHING;
+
+    if (mLag > OVERLOAD_LAG_HIGH || backlog > OVERLOAD_BACKLOG_HIGH) {
+        mLow = 0;
+        if (++mHigh >= OVERLOAD_SHED_PROBES && mLevel < LOAD_LEVELS - 1) {
+            LOG (LOG_MAIN, "%s - overloaded, lag %.1f ms, backlog %lld bytes", CLASS_INFO,
+                 mLag, backlog);
+            setLevel(mLevel + 1);
+            mHigh = 0;
+        }
+    } else if (mLag < OVERLOAD_LAG_LOW && backlog < OVERLOAD_BACKLOG_LOW) {
+        mHigh = 0;
+        if (++mLow >= OVERLOAD_RESTORE_PROBES && mLevel > LOAD_FULL) {
+            setLevel(mLevel - 1);
+            mLow = 0;
+        }
+    } else {
+        /* between thresholds - keep current level */
+        mHigh = mLow = 0;
+    }
+}
+
+
+void OverloadController::setLevel(int level)
+{
+    if (level > mLevel)
+        mShed++;
+    else
+        mRestored++;
+
+    mLevel = level;
+
+    LOG (LOG_MAIN, "%s - load level %d - %s (shed %llu, restored %llu)", CLASS_INFO,
+         mLevel, levelNames[mLevel], mShed, mRestored);
+    emit printMessage(QString("load level %1 - %2").arg(mLevel).arg(levelNames[mLevel]),
+                      mLevel == LOAD_FULL ? 0 : 1);
+    emit levelChanged(mLevel);
+}
+
+
+int OverloadController::getLevel(void)
+{
+    return mLevel;
+}
+
+
+quint64 OverloadController::getShedCount(void)
+{
+    return mShed;
+}
+
+
+quint64 OverloadController::getRestoreCount(void)
+{
+    return mRestored;
+}
@@ -0,0 +1,85 @@
+/**
+ * \class OverloadController
+ *
+ * \brief
+ *
+ * This class watches event loop lag and backlog of CAN data waiting to be
+ * decoded. When the dashboard falls behind it sheds optional work step by
+ * step (LoadLevel) and brings full quality back when load drops.
+ * Alerts delivery and capture are never shed.
+ *
+ * \version 1.0
+ *
+ * \date 2019/02/20 19:42:17
+ *
+ */
+#ifndef OVERLOAD_H
+#define OVERLOAD_H
+
+#include <QObject>
+#include <QTimer>
+#include <QElapsedTimer>
+#include "../connections/connections.h"
+
+#define OVERLOAD_PROBE_MS           100     /* lag probe interval */
+#define OVERLOAD_LAG_HIGH           40      /* [ms] */
+#define OVERLOAD_LAG_LOW            10      /* [ms] */
+#define OVERLOAD_BACKLOG_HIGH       8192    /* [bytes] */
+#define OVERLOAD_BACKLOG_LOW        1024    /* [bytes] */
+#define OVERLOAD_SHED_PROBES        3       /* overloaded probes before shedding next level */
+#define OVERLOAD_RESTORE_PROBES     20      /* relaxed probes before restoring previous level */
+#define OVERLOAD_CHART_FACTOR       4       /* chart refresh divider at LOAD_CHART_RATE */
+
+/* load levels, every level sheds also work of lower levels */
+enum LoadLevel {
+    LOAD_FULL = 0,
+    LOAD_CHART_RATE, /* charts are refreshed less often */
+    LOAD_CHART_ANTIALIASING, /* charts drawn without antialiasing */
+    LOAD_CAN_ECHO, /* CAN data not printed to console */
+    LOAD_NEEDLE_SMOOTHING, /* rpm needle drawn without antialiasing and interpolation */
+    LOAD_LEVELS
+};
+
+class OverloadController : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief OverloadController - creates controller and starts probing
+     * @param connection - source of CAN backlog
+     * @param parent - parent object
+     */
+    explicit OverloadController(Connections *connection, QObject *parent = 0);
+    ~OverloadController();
+
+    /// returns current load level (LoadLevel)
+    int getLevel(void);
+    /// returns number of level changes to higher (shed) and lower level (restored)
+    quint64 getShedCount(void);
+    quint64 getRestoreCount(void);
+
+signals:
+    /// signal emitted when load level changed
+    void levelChanged(int);
+    /// signal emitted with message to print
+    void printMessage(QString, int);
+
+private slots:
+    /// measures event loop lag and backlog, changes level if needed
+    void probe(void);
+
+private:
+    /// sets new level, logs and counts change
+    void setLevel(int level);
+
+    Connections *con; /// - pointer to Connections class
+    QTimer mTimer; /// - probe timer
+    QElapsedTimer mClock; /// - measures real probe interval
+    double mLag; /// - smoothed event loop lag [ms]
+    int mLevel; /// - current LoadLevel
+    int mHigh, mLow; /// - number of consecutive overloaded and relaxed probes
+    quint64 mShed, mRestored; /// - number of level changes
+};
+
+#endif // OVERLOAD_H
@@ -0,0 +1,233 @@
+#include <QPainter>
+#include <QPaintEvent>
+#include <QCoreApplication>
+#include <QEvent>
+#include <QFontMetrics>
+#include <algorithm>
+#include "perfoverlay.h"
+#include "../common/logger.h"
+#include "../common/pipeline.h"
+
+#define CLASS_INFO          "perf overlay"
+#define OVERLAY_FONT        "Monospace"
+#define OVERLAY_FONT_SIZE   9
+
+
+PerfOverlay::PerfOverlay(QWidget *window, Connections *connection, RenderScheduler *scheduler)
+    : QWidget(window)
+{
+    LOG (LOG_MAINWINDOW, "%s - in constructor", CLASS_INFO);
+
+    mWindow = window;
+    con = connection;
+    render = scheduler;
+    mRequested = mPinned = false;
+    mActive = mInside = false;
+    mPending = -1;
+    mPendingFrame = 0;
+    mLatencyHead = 0;
+    mLatencies.reserve(OVERLAY_LATENCIES);
+    resetInterval();
+
+    QFont font(OVERLAY_FONT, OVERLAY_FONT_SIZE);
+    font.setStyleHint(QFont::TypeWriter);
+    setFont(font);
+    setAttribute(Qt::WA_TransparentForMouseEvents);
+
+    connect (&mTimer, &QTimer::timeout, this, &PerfOverlay::refresh);
+    hide();
+}
+
+
+void PerfOverlay::setPinned(bool pinned)
+{
+    mPinned = pinned;
+    apply();
+}
+
+
+void PerfOverlay::setRequested(bool requested)
+{
+    mRequested = requested;
+    apply();
+}
+
+
+bool PerfOverlay::isActive(void)
+{
+    return mActive;
+}
+
+
+qint64 PerfOverlay::area(const QRegion &region)
+{
+    QVector<QRect> rects = region.rects();
+    qint64 pixels = 0;
+
+    for (int i = 0; i < rects.size(); ++i)
+        pixels += qint64(rects.at(i).width()) * rects.at(i).height();
+
+    return pixels;
+}
+
+
+qint64 PerfOverlay::getLatency(double percentile)
+{
+    if (mLatencies.isEmpty())
+        return 0;
+
+    QVector<qint64> sorted(mLatencies);
+    int index = qBound(0, int(percentile / 100 * (sorted.size() - 1) + 0.5), sorted.size() - 1);
+    std::nth_element(sorted.begin(), sorted.begin() + index, sorted.end());
+
+    return sorted.at(index);
+}
+
+
+void PerfOverlay::apply(void)
+{
+    bool active = mRequested || mPinned;
+    if (active == mActive)
+        return;
+
+    LOG (LOG_MAINWINDOW, "%s - %s", CLASS_INFO, active ? "shown" : "hidden");
+
+    mActive = active;
+    if (active) {
+        mLatencies.clear();
+        mLatencyHead = 0;
+        mPending = -1;
+        resetInterval();
+        mLines.clear();
+        mLines << "measuring...";
+        QCoreApplication::instance()->installEventFilter(this);
+        connect (con, &Connections::telemetryDelivered, this, &PerfOverlay::telemetryDelivered);
+        mTimer.start(OVERLAY_REFRESH_MS);
+        place();
+        show();
+        raise();
+    } else {
+        QCoreApplication::instance()->removeEventFilter(this);
+        disconnect (con, &Connections::telemetryDelivered, this, &PerfOverlay::telemetryDelivered);
+        mTimer.stop();
+        hide();
+    }
+}
+
+
+void PerfOverlay::resetInterval(void)
+{
+    mFrames = 0;
+    mWorstFrame = 0;
+    mPaintedArea = 0;
+    mCanFrames = gStages[STAGE_FRAMES].processed + gStages[STAGE_FRAMES].skipped;
+    mInterval.start();
+}
+
+
+bool PerfOverlay::eventFilter(QObject *obj, QEvent *event)
+{
+    /* paint events of all widgets (parents repainted under children included) */
+    if (event->type() == QEvent::Paint) {
+        mPaintedArea += area(static_cast<QPaintEvent *>(event)->region());
+        return false;
+    }
+
+    if (obj != mWindow)
+        return false;
+
+    if (event->type() == QEvent::Resize) {
+        place();
+        return false;
+    }
+
+    /* update request of window paints and flushes all dirty widgets */
+    if (event->type() == QEvent::UpdateRequest && !mInside) {
+        qint64 start = render->now();
+
+        mInside = true;
+        obj->event(event);
+        mInside = false;
+
+        qint64 end = render->now();
+        mFrames++;
+        mWorstFrame = qMax(mWorstFrame, end - start);
+
+        /* value is on screen when render clock ran since its delivery */
+        if (mPending >= 0 && render->getStats().frames != mPendingFrame) {
+            qint64 latency = con->getCapture()->now() - mPending;
+            if (mLatencies.size() < OVERLAY_LATENCIES)
+                mLatencies.append(latency);
+            else
+                mLatencies[mLatencyHead] = latency;
+            mLatencyHead = (mLatencyHead + 1) % OVERLAY_LATENCIES;
+            mPending = -1;
+        }
+        return true;
+    }
+
+    return false;
+}
+
+
+void PerfOverlay::telemetryDelivered(qint64 received)
+{
+    /* keep the oldest value waiting for paint */
+    if (mPending >= 0)
+        return;
+
+    mPending = received;
+    mPendingFrame = render->getStats().frames;
+}
+
+
+void PerfOverlay::refresh(void)
+{
+    double seconds = mInterval.nsecsElapsed() / 1e9;
+    /* stage counters are cleared when connection is closed */
+    quint64 canFrames = gStages[STAGE_FRAMES].processed + gStages[STAGE_FRAMES].skipped;
+    quint64 decoded = (canFrames >= mCanFrames) ? canFrames - mCanFrames : canFrames;
+
+    mLines.clear();
+    mLines << QString("fps %1  worst %2 ms")
+              .arg(mFrames / seconds, 0, 'f', 1).arg(mWorstFrame / 1000.0, 0, 'f', 1);
+    mLines << QString("can %1/s  queue %2 B")
+              .arg(decoded / seconds, 0, 'f', 0).arg(con->getBacklog());
+    mLines << QString("painted %1 kpx/s")
+              .arg(mPaintedArea / 1000.0 / seconds, 0, 'f', 1);
+    mLines << QString("latency p50 %1  p95 %2  p99 %3 ms")
+              .arg(getLatency(50) / 1000.0, 0, 'f', 1).arg(getLatency(95) / 1000.0, 0, 'f', 1)
+              .arg(getLatency(99) / 1000.0, 0, 'f', 1);
+    resetInterval();
+
+    place();
+    update();
+}
+
+
+void PerfOverlay::place(void)
+{
+    QFontMetrics metrics(font());
+    int width = 0;
+
+    for (int i = 0; i < mLines.size(); ++i)
+        width = qMax(width, metrics.width(mLines.at(i)));
+
+    resize(width + 2 * OVERLAY_MARGIN, mLines.size() * metrics.height() + 2 * OVERLAY_MARGIN);
+    move(mWindow->width() - this->width(), 0);
+}
+
+
+void PerfOverlay::paintEvent(QPaintEvent *event)
+{
+    Q_UNUSED(event);
+
+    QPainter painter(this);
+    QFontMetrics metrics(font());
+
+    painter.fillRect(rect(), QColor(0, 0, 0, 180));
+    painter.setPen(QColor("#00ffc1"));
+    for (int i = 0; i < mLines.size(); ++i)
+        painter.drawText(OVERLAY_MARGIN, OVERLAY_MARGIN + i * metrics.height() + metrics.ascent(),
+                         mLines.at(i));
+}
@@ -0,0 +1,108 @@
+/**
+ * \class PerfOverlay
+ *
+ * \brief
+ *
+ * This class is an on-screen overlay with live performance of the dashboard:
+ * painted frames per second and worst frame (window flush) time, decoded CAN
+ * frames per second, bytes of CAN data waiting to be decoded, painted area
+ * (pixels of paint events per second) and percentiles of sample-to-pixel
+ * latency. Latency is measured from receive time of the oldest delivered
+ * telemetry value to the end of the first window flush after a render
+ * clock frame rendered it.
+ *
+ * Window is probed only while overlay is visible, hidden overlay has no
+ * event filter, connections nor timer.
+ *
+ * \version 1.0
+ *
+ * \date 2019/03/10 20:14:51
+ *
+ */
+#ifndef PERFOVERLAY_H
+#define PERFOVERLAY_H
+
+#include <QWidget>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QStringList>
+#include <QVector>
+#include <QRegion>
+#include "renderscheduler.h"
+#include "../connections/connections.h"
+
+#define OVERLAY_REFRESH_MS      500     /* text refresh interval */
+#define OVERLAY_LATENCIES       512     /* latency samples kept for percentiles */
+#define OVERLAY_MARGIN          4       /* [px] */
+
+class PerfOverlay : public QWidget
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief PerfOverlay - creates hidden overlay in top right corner of window
+     * @param window - probed top level window (parent)
+     * @param connection - source of CAN frames and telemetry
+     * @param scheduler - render clock
+     */
+    PerfOverlay(QWidget *window, Connections *connection, RenderScheduler *scheduler);
+
+    /// pins overlay (command line), pinned overlay is shown regardless of settings
+    void setPinned(bool pinned);
+    /// returns true if overlay is shown
+    bool isActive(void);
+    /// returns percentile (0 - 100) of kept latency samples [us]
+    qint64 getLatency(double percentile);
+    /// returns number of pixels of region
+    static qint64 area(const QRegion &region);
+
+public slots:
+    /// shows/hides overlay (settings)
+    void setRequested(bool requested);
+
+protected:
+    /**
+     * @brief eventFilter - reimplemented method, times window flushes, sums painted area
+     * and follows window size
+     */
+    bool eventFilter(QObject *obj, QEvent *event);
+    /**
+     * @brief paintEvent - reimplemented method, draws statistics
+     */
+    void paintEvent(QPaintEvent *event);
+
+private slots:
+    /// remembers delivered telemetry, its latency is taken at next painted frame
+    void telemetryDelivered(qint64 received);
+    /// computes rates and percentiles, updates text
+    void refresh(void);
+
+private:
+    /// starts/stops probing and shows/hides overlay
+    void apply(void);
+    /// moves overlay to top right corner of window
+    void place(void);
+    /// clears counters of refresh interval
+    void resetInterval(void);
+
+    QWidget *mWindow; /// - probed window
+    Connections *con; /// - pointer to Connections class
+    RenderScheduler *render; /// - pointer to RenderScheduler class
+    bool mRequested, mPinned; /// - overlay requested by settings/command line
+    bool mActive; /// - keeps information whether window is probed
+    bool mInside; /// - window flush is being delivered by overlay
+    QTimer mTimer; /// - refresh timer
+    QElapsedTimer mInterval; /// - measures refresh interval
+    quint64 mFrames; /// - window flushes in interval
+    qint64 mWorstFrame; /// - worst window flush in interval [us]
+    qint64 mPaintedArea; /// - pixels of paint events in interval
+    quint64 mCanFrames; /// - decoded CAN frames at interval start
+    qint64 mPending; /// - receive time of delivered value not yet painted [us], -1 if none
+    quint64 mPendingFrame; /// - render clock frame counter at delivery
+    QVector<qint64> mLatencies; /// - ring of latency samples [us]
+    int mLatencyHead; /// - next position in ring
+    QStringList mLines; /// - displayed text
+};
+
+#endif // PERFOVERLAY_H
@@ -0,0 +1,255 @@
+#include <QStringList>
+#include "renderscheduler.h"
+#include "../common/logger.h"
+
+#define CLASS_INFO          "render"
+#define US_PER_SEC          1000000
+
+
+RenderScheduler::RenderScheduler(QObject *parent)
+    : QObject(parent)
+{
+    LOG (LOG_MAINWINDOW, "%s - in constructor", CLASS_INFO);
+
+    mAnyDirty = false;
+    mActive = false;
+    mPage = PAGE_DRIVE;
+    mLastFrame = 0;
+
+    mTimer.setTimerType(Qt::PreciseTimer);
+    connect (&mTimer, &QTimer::timeout, this, &RenderScheduler::renderFrame);
+    mClock.start();
+    setRate(RENDER_DEFAULT_RATE);
+}
+
+
+void RenderScheduler::addTarget(QObject *owner, int input, std::function<void(float)> render,
+                                bool continuous, int page)
+{
+    LOG (LOG_MAINWINDOW, "%s - target of input %d added%s, page %d", CLASS_INFO, input,
+         continuous ? " (continuous)" : "", page);
+
+    if (input >= mValues.size()) {
+        mValues.resize(input + 1);
+        mTimes.resize(input + 1);
+        mSeq.resize(input + 1);
+    }
+
+    Target target;
+    target.owner = owner;
+    target.input = input;
+    target.render = render;
+    target.continuous = continuous;
+    target.page = page;
+    /* new target shows latest value in the next frame */
+    target.seq = mSeq.at(input) - 1;
+    mTargets.append(target);
+
+    updateLive();
+}
+
+
+void RenderScheduler::removeTargets(QObject *owner)
+{
+    for (int i = mTargets.size() - 1; i >= 0; --i) {
+        if (mTargets.at(i).owner == owner)
+            mTargets.remove(i);
+    }
+
+    updateLive();
+}
+
+
+void RenderScheduler::setPage(int page)
+{
+    if (page == mPage)
+        return;
+
+    LOG (LOG_MAINWINDOW, "%s - page %d visible", CLASS_INFO, page);
+
+    mPage = page;
+    updateLive();
+}
+
+
+bool RenderScheduler::isLive(int page) const
+{
+    return page == RENDER_ALL_PAGES || page == mPage;
+}
+
+
+void RenderScheduler::updateLive(void)
+{
+    mLive.clear();
+    for (int i = 0; i < mTargets.size(); ++i) {
+        if (isLive(mTargets.at(i).page))
+            mLive.append(i);
+    }
+
+    /* targets which became live render values they missed */
+    mAnyDirty = true;
+}
+
+
+int RenderScheduler::getSubscriberCount(int input, bool live)
+{
+    int count = 0;
+
+    for (int i = 0; i < mTargets.size(); ++i) {
+        const Target &t = mTargets.at(i);
+        if (t.input == input && (!live || isLive(t.page)))
+            count++;
+    }
+
+    return count;
+}
+
+
+void RenderScheduler::setRate(int rate)
+{
+    mRate = qBound(RENDER_MIN_RATE, rate, RENDER_MAX_RATE);
+
+    LOG (LOG_MAINWINDOW, "%s - render clock %d Hz", CLASS_INFO, mRate);
+
+    mTimer.start(1000 / mRate);
+}
+
+
+int RenderScheduler::getRate(void)
+{
+    return mRate;
+}
+
+
+bool RenderScheduler::isActive(void) const
+{
+    return mActive;
+}
+
+
+const RenderStats &RenderScheduler::getStats(void)
+{
+    return mStats;
+}
+
+
+qint64 RenderScheduler::now(void) const
+{
+    return mClock.nsecsElapsed() / 1000;
+}
+
+
+qint64 RenderScheduler::getFrameTime(void)
+{
+    return mLastFrame;
+}
+
+
+qint64 RenderScheduler::getSampleTime(int input)
+{
+    return (input < mTimes.size()) ? mTimes.at(input) : 0;
+}
+
+
+void RenderScheduler::setValue(int input, float value)
+{
+    if (input >= mValues.size()) {
+        mValues.resize(input + 1);
+        mTimes.resize(input + 1);
+        mSeq.resize(input + 1);
+    }
+
+    mValues[input] = value;
+    mTimes[input] = now();
+    mSeq[input]++;
+    mAnyDirty = true;
+}
+
+
+void RenderScheduler::setActive(bool active)
+{
+    mActive = active;
+}
+
+
+void RenderScheduler::renderFrame(void)
+{
+    qint64 start = now();
+    qint64 period = US_PER_SEC / mRate;
+    int rendered = 0;
+
+    /* clock fired late - previous frame or event loop took too long */
+    if (mLastFrame) {
+        qint64 late = start - mLastFrame - period;
+        if (late > period / 2)
+            mStats.missed += qMax(qint64(1), late / period);
+    }
+    mLastFrame = start;
+
+    if (mAnyDirty || mActive) {
+        for (int i = 0; i < mLive.size(); ++i) {
+            Target &t = mTargets[mLive.at(i)];
+            quint32 seq = mSeq.at(t.input);
+            /* every value is rendered exactly once by every live target */
+            if (t.seq != seq || (t.continuous && mActive)) {
+                t.seq = seq;
+                t.render(mValues.at(t.input));
+                rendered++;
+            }
+        }
+        mAnyDirty = false;
+    }
+
+    qint64 cost = now() - start;
+
+    mStats.frames++;
+    mStats.renders += rendered;
+    mStats.totalCost += cost;
+    if (!rendered)
+        mStats.idle++;
+    if (cost > mStats.maxCost)
+        mStats.maxCost = cost;
+    if (cost > period * RENDER_BUDGET_SHARE) {
+        mStats.overBudget++;
+        LOG (LOG_MAINWINDOW_DATA, "%s - frame over budget, %lld us, %d targets", CLASS_INFO,
+             cost, rendered);
+    }
+}
+
+
+void RenderScheduler::printStats(void)
+{
+    quint64 busy = mStats.frames - mStats.idle;
+    QString msg = QString("render %1 Hz: %2 frames (%3 idle), %4 renders, cost mean %5 ms, "
+                          "max %6 ms, %7 over budget, %8 missed")
+            .arg(mRate).arg(mStats.frames).arg(mStats.idle).arg(mStats.renders)
+            .arg(busy ? mStats.totalCost / 1000.0 / busy : 0, 0, 'f', 2)
+            .arg(mStats.maxCost / 1000.0, 0, 'f', 2)
+            .arg(mStats.overBudget).arg(mStats.missed);
+
+    LOG (LOG_MAINWINDOW, "%s - %s", CLASS_INFO, STR(msg));
+    emit printMessage(msg, 0);
+
+    /* subscribers of inputs, live on visible page / registered */
+    QStringList subscribers;
+    for (int i = 0; i < mValues.size(); ++i) {
+        int count = getSubscriberCount(i);
+        if (!count)
+            continue;
+        QString name = (i < CHANNEL_COUNT) ? QString(channelNames[i]) :
+                                             QString("computed %1").arg(i - RENDER_COMPUTED);
+        subscribers << QString("%1 %2/%3").arg(name).arg(getSubscriberCount(i, true)).arg(count);
+    }
+    msg = QString("render page %1 subscribers: %2").arg(mPage).arg(subscribers.join(", "));
+
+    LOG (LOG_MAINWINDOW, "%s - %s", CLASS_INFO, STR(msg));
+    emit printMessage(msg, 0);
+
+    resetStats();
+}
+
+
+void RenderScheduler::resetStats(void)
+{
+    mStats.reset();
+}
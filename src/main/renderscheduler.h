@@ -0,0 +1,157 @@
+/**
+ * \class RenderScheduler
+ *
+ * \brief
+ *
+ * This class decouples widget repaints from CAN rate. Decoded values are
+ * only stored when they arrive, a render clock (display rate, e.g. 30 Hz)
+ * wakes once per frame and calls render targets whose input changed.
+ * Every frame is measured against a budget, late frames are counted as
+ * missed deadlines.
+ *
+ * Inputs are telemetry channels (TelemetryChannel) followed by computed
+ * channels (RENDER_COMPUTED + index).
+ *
+ * Targets can be bound to a page of main window, only targets of the
+ * visible page are live (checked in frames). A target is rendered once per
+ * input value, so target of shown page catches up with value which changed
+ * while the page was hidden, and hidden pages cost nothing.
+ *
+ * \version 1.0
+ *
+ * \date 2019/02/27 21:14:50
+ *
+ */
+#ifndef RENDERSCHEDULER_H
+#define RENDERSCHEDULER_H
+
+#include <QObject>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QVector>
+#include <functional>
+#include "../common/telemetry.h"
+
+#define RENDER_DEFAULT_RATE     30      /* [Hz] */
+#define RENDER_MIN_RATE         5       /* [Hz] */
+#define RENDER_MAX_RATE         60      /* [Hz] */
+#define RENDER_BUDGET_SHARE     0.5     /* part of frame period available for rendering */
+#define RENDER_COMPUTED         CHANNEL_COUNT
+#define RENDER_ALL_PAGES        -1      /* target rendered on every page */
+
+/* pages of main window stacked widget */
+enum RenderPage {
+    PAGE_DRIVE = 0,
+    PAGE_ALERTS,
+    PAGE_STATS,
+    PAGE_SETTINGS
+};
+
+struct RenderStats {
+    quint64 frames; /// - number of render clock ticks
+    quint64 idle; /// - frames with nothing to render
+    quint64 renders; /// - number of target renders
+    quint64 overBudget; /// - frames which exceeded budget
+    quint64 missed; /// - frames missed because clock fired late
+    qint64 totalCost; /// - sum of frame costs [us]
+    qint64 maxCost; /// - worst frame cost [us]
+
+    RenderStats() { reset(); }
+
+    void reset(void)
+    {
+        frames = idle = renders = overBudget = missed = 0;
+        totalCost = maxCost = 0;
+    }
+};
+
+class RenderScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief RenderScheduler - creates scheduler and starts render clock
+     * @param parent - parent object
+     */
+    explicit RenderScheduler(QObject *parent = 0);
+
+    /**
+     * @brief addTarget - registers render callback
+     * @param owner - object owning target (used to remove targets)
+     * @param input - index of input value
+     * @param render - called with latest value in frame when input changed
+     * @param continuous - render in every frame while active (charts)
+     * @param page - RenderPage on which target is live, RENDER_ALL_PAGES if always
+     */
+    void addTarget(QObject *owner, int input, std::function<void(float)> render,
+                   bool continuous = false, int page = RENDER_ALL_PAGES);
+    /// removes all targets of owner
+    void removeTargets(QObject *owner);
+    /// sets render clock rate [Hz]
+    void setRate(int rate);
+    int getRate(void);
+    /// returns true if continuous targets are rendered (data is flowing)
+    bool isActive(void) const;
+    /// returns frame statistics
+    const RenderStats &getStats(void);
+    /// returns time of render clock [us]
+    qint64 now(void) const;
+    /// returns start time of current frame [us]
+    qint64 getFrameTime(void);
+    /// returns arrival time of latest value of input [us]
+    qint64 getSampleTime(int input);
+    /// returns number of targets of input, only live targets (visible page) if live is set
+    int getSubscriberCount(int input, bool live = false);
+
+signals:
+    /// signal emitted with message to print
+    void printMessage(QString, int);
+
+public slots:
+    /// stores latest value of input, it is rendered in the next frame
+    void setValue(int input, float value);
+    /// enables/disables rendering of continuous targets (data is flowing)
+    void setActive(bool active);
+    /// sets visible RenderPage, only its targets (and targets of all pages) are rendered
+    void setPage(int page);
+    /// prints and resets frame statistics
+    void printStats(void);
+    /// resets frame statistics (starts new statistics window)
+    void resetStats(void);
+
+private slots:
+    /// renders one frame
+    void renderFrame(void);
+
+private:
+    /// rebuilds list of targets live on visible page
+    void updateLive(void);
+    /// returns true if target of page is live on visible page
+    bool isLive(int page) const;
+
+    struct Target {
+        QObject *owner; /// - owner of target
+        int input; /// - index of input value
+        std::function<void(float)> render; /// - render callback
+        bool continuous; /// - render in every frame while active
+        int page; /// - RenderPage of target or RENDER_ALL_PAGES
+        quint32 seq; /// - sequence number of rendered input value
+    };
+
+    QVector<Target> mTargets; /// - registered targets
+    QVector<int> mLive; /// - indexes of targets live on visible page
+    QVector<float> mValues; /// - latest input values
+    QVector<qint64> mTimes; /// - arrival times of latest input values [us]
+    QVector<quint32> mSeq; /// - sequence numbers of input values
+    bool mAnyDirty; /// - keeps information whether any input changed
+    int mPage; /// - visible RenderPage
+    bool mActive; /// - keeps information whether continuous targets are rendered
+    int mRate; /// - render clock rate [Hz]
+    QTimer mTimer; /// - render clock
+    QElapsedTimer mClock; /// - measures frame cost and lateness
+    qint64 mLastFrame; /// - start of previous frame [us]
+    RenderStats mStats; /// - frame statistics
+};
+
+#endif // RENDERSCHEDULER_H
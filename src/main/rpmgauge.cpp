@@ -0,0 +1,320 @@
+#include <QPainter>
+#include <QPaintEvent>
+#include <QtMath>
+#include "rpmgauge.h"
+#include "../common/logger.h"
+#include "../common/parameters.h"
+
+#define CLASS_INFO          "rpm gauge"
+#define DOT_SIZE            31
+#define NEEDLE_COLOR        "#22e2a2"
+#define CAPTION_COLOR       "#6affcd"
+#define NEEDLE_WIDTH        5
+#define PINTOP_WIDTH        10
+#define MIN_INTERVAL        1000    /* [us] */
+#define MAX_INTERVAL        500000  /* [us] */
+#define SETTLE_FACTOR       0.3     /* part of distance to sample made per frame when sample is overdue */
+
+/* positions of dots (rpm arc from left bottom to right bottom) */
+static const QPoint dotPositions[GAUGE_DOTS] = {
+    QPoint(14, 195), QPoint(7, 172), QPoint(1, 148), QPoint(2, 124),
+    QPoint(8, 99), QPoint(18, 75), QPoint(31, 54), QPoint(48, 36),
+    QPoint(68, 21), QPoint(89, 11), QPoint(112, 4), QPoint(136, 1),
+    QPoint(159, 5), QPoint(182, 11), QPoint(205, 21), QPoint(224, 37),
+    QPoint(241, 55), QPoint(253, 75), QPoint(263, 98), QPoint(269, 121),
+    QPoint(270, 145), QPoint(266, 169), QPoint(257, 191)
+};
+
+struct Caption {
+    QRect rect;
+    const char *text;
+    const char *family;
+    int size;
+    int weight;
+};
+
+static const Caption captions[] = {
+    { QRect(120, 240, 51, 21), "km/h", "Gill Sans MT", 14, 75 },
+    { QRect(30, 130, 20, 20), "1", "Gill Sans MT", 12, 75 },
+    { QRect(70, 60, 20, 20), "2", "Gill Sans MT", 12, 75 },
+    { QRect(140, 40, 16, 16), "3", "Gill Sans MT", 12, 75 },
+    { QRect(200, 60, 20, 20), "4", "Gill Sans MT", 12, 75 },
+    { QRect(240, 130, 20, 21), "5", "Gill Sans MT", 12, 75 },
+    { QRect(230, 200, 20, 21), "6", "Gill Sans MT", 12, 75 },
+    { QRect(101, 101, 98, 19), "rpm * 1000", "Ubuntu", 14, 50 }
+};
+
+
+RpmGauge::RpmGauge(QWidget *parent)
+    : QWidget(parent)
+{
+    LOG (LOG_RPM, "%s - in constructor", CLASS_INFO);
+
+    setFixedSize(GAUGE_SIZE, GAUGE_SIZE);
+
+    QColor color(NEEDLE_COLOR);
+    needlePen = QPen(QBrush(color), NEEDLE_WIDTH, Qt::SolidLine, Qt::RoundCap);
+    pintopPen = QPen(QBrush(color), PINTOP_WIDTH, Qt::SolidLine, Qt::RoundCap);
+
+    /* needle geometry of former graphics view (301x270) */
+    pivot = QPointF(150, 135);
+    pintop = QRectF(pivot.x() - 2, pivot.y() - 4, 10, 10);
+    needleLength = 150 - 10.0;
+
+    mValue = 0;
+    mDots = 0;
+    mSmoothing = true;
+    mPartial = false;
+    mInterpolation = true;
+    mHorizon = 0;
+    mSamples = 0;
+    mTime[0] = mTime[1] = 0;
+    mSample[0] = mSample[1] = 0;
+    mStart = mShown = 0;
+
+    renderLayers();
+}
+
+
+void RpmGauge::renderLayers(void)
+{
+    LOG (LOG_RPM, "%s - rendering static layers", CLASS_INFO);
+
+    background = QPixmap(GAUGE_SIZE, GAUGE_SIZE);
+    background.fill(Qt::transparent);
+    overlay = QPixmap(GAUGE_SIZE, GAUGE_SIZE);
+    overlay.fill(Qt::transparent);
+
+    /* dial artwork */
+    QPixmap dial("img/blackcircle.png");
+    hasBackground = !dial.isNull();
+    if (hasBackground) {
+        QPainter p(&background);
+        p.setRenderHint(QPainter::SmoothPixmapTransform);
+        p.drawPixmap(background.rect(), dial);
+    }
+
+    /* dots are scaled once (as QLabel scaledContents did on every repaint) */
+    dotPixmaps.clear();
+    for (int i = 0; i < GAUGE_DOTS; ++i) {
+        QPixmap dot(QString(":/colorized_circles/colorized_circles/circle%1.png").arg(i + 1));
+        dotPixmaps.append(dot.scaled(DOT_SIZE, DOT_SIZE, Qt::IgnoreAspectRatio, Qt::SmoothTransformation));
+    }
+
+    QPainter p(&overlay);
+    p.setRenderHint(QPainter::SmoothPixmapTransform);
+
+    QPixmap pin("img/pintop.png");
+    if (!pin.isNull())
+        p.drawPixmap(QRect(130, 130, 41, 41), pin);
+
+    /* captions */
+    p.setPen(QColor(CAPTION_COLOR));
+    for (unsigned i = 0; i < sizeof(captions)/sizeof(captions[0]); ++i) {
+        QFont font(captions[i].family, captions[i].size, captions[i].weight, true);
+        p.setFont(font);
+        p.drawText(captions[i].rect, Qt::AlignRight | Qt::AlignVCenter, captions[i].text);
+    }
+
+    /* dark dots are on top of everything */
+    for (int i = 0; i < GAUGE_DOTS; ++i) {
+        QPixmap dot(QString(":/dark_colorized_circles/dark_colorized_circles/circle%1.png").arg(i + 1));
+        p.drawPixmap(QRect(dotPositions[i], QSize(DOT_SIZE, DOT_SIZE)), dot);
+    }
+}
+
+
+int RpmGauge::litDots(int value)
+{
+    return qBound(0, int(value/(MAX_RPM_VALUE / GAUGE_DOTS)), GAUGE_DOTS);
+}
+
+
+QLineF RpmGauge::needleLine(int value)
+{
+    double angle = qDegreesToRadians(ANGLE_RANGE * value / MAX_RPM_VALUE + (360 - ANGLE_RANGE)/2);
+
+    return QLineF(pivot, pivot + QPointF(-needleLength * qSin(angle), needleLength * qCos(angle)));
+}
+
+
+QRect RpmGauge::needleRect(int value)
+{
+    QLineF line = needleLine(value);
+    int margin = NEEDLE_WIDTH / 2 + 2;
+
+    return QRectF(line.p1(), line.p2()).normalized().toAlignedRect()
+            .adjusted(-margin, -margin, margin, margin);
+}
+
+
+QRegion RpmGauge::needleRegion(int value)
+{
+    if (!mPartial)
+        return QRegion(needleRect(value));
+
+    /* diagonal needle covers a small part of its bounding rect */
+    QLineF line = needleLine(value);
+    int margin = NEEDLE_WIDTH / 2 + 2;
+    QRegion region(pintop.adjusted(-PINTOP_WIDTH, -PINTOP_WIDTH, PINTOP_WIDTH, PINTOP_WIDTH).toAlignedRect());
+
+    for (int i = 0; i < GAUGE_NEEDLE_PARTS; ++i) {
+        QPointF p1 = line.pointAt(double(i) / GAUGE_NEEDLE_PARTS);
+        QPointF p2 = line.pointAt(double(i + 1) / GAUGE_NEEDLE_PARTS);
+        region += QRectF(p1, p2).normalized().toAlignedRect().adjusted(-margin, -margin, margin, margin);
+    }
+
+    return region;
+}
+
+
+void RpmGauge::setValue(int value)
+{
+    if (value == mValue)
+        return;
+
+    int dots = litDots(value);
+    QRegion dirty(needleRegion(mValue));
+    dirty += needleRegion(value);
+
+    /* dots which changed state */
+    for (int i = qMin(dots, mDots); i < qMax(dots, mDots); ++i)
+        dirty += QRect(dotPositions[i], QSize(DOT_SIZE, DOT_SIZE));
+
+    mValue = value;
+    mDots = dots;
+    update(dirty);
+}
+
+
+int RpmGauge::getValue(void)
+{
+    return mValue;
+}
+
+
+void RpmGauge::setSmoothing(bool enable)
+{
+    if (enable == mSmoothing)
+        return;
+
+    mSmoothing = enable;
+    update(needleRegion(mValue));
+}
+
+
+void RpmGauge::setPartialRepaint(bool enable)
+{
+    LOG (LOG_RPM, "%s - partial repaint %s", CLASS_INFO, enable ? "enabled" : "disabled");
+
+    mPartial = enable;
+    updateOpaque();
+    update();
+}
+
+
+void RpmGauge::updateOpaque(void)
+{
+    /* opaque widget hides its parents, Qt does not repaint them under it */
+    setAttribute(Qt::WA_OpaquePaintEvent, mPartial && palette().brush(backgroundRole()).isOpaque());
+}
+
+
+void RpmGauge::changeEvent(QEvent *event)
+{
+    if (event->type() == QEvent::PaletteChange)
+        updateOpaque();
+
+    QWidget::changeEvent(event);
+}
+
+
+void RpmGauge::addSample(int value, qint64 time)
+{
+    mTime[0] = mTime[1];
+    mSample[0] = mSample[1];
+    mTime[1] = time;
+    mSample[1] = value;
+    mStart = mShown;
+    if (mSamples < 2)
+        mSamples++;
+}
+
+
+int RpmGauge::interpolate(qint64 now)
+{
+    if (!mInterpolation || mSamples < 2) {
+        mShown = mSample[1];
+        return qRound(mShown);
+    }
+
+    qint64 interval = qBound(qint64(MIN_INTERVAL), mTime[1] - mTime[0], qint64(MAX_INTERVAL));
+    qint64 elapsed = qMax(qint64(0), now - mTime[1]);
+
+    if (elapsed > interval + mHorizon) {
+        /* next sample is overdue - value has not changed (change driven data),
+         * settle on the latest sample */
+        mShown += (mSample[1] - mShown) * SETTLE_FACTOR;
+        if (qAbs(mSample[1] - mShown) < 1)
+            mShown = mSample[1];
+    } else {
+        /* target is the latest sample, extrapolated along last slope */
+        double slope = (mSample[1] - mSample[0]) / interval;
+        double target = mSample[1] + slope * qMin(elapsed, mHorizon);
+        double alpha = qMin(1.0, double(elapsed) / interval);
+
+        mShown = mStart + (target - mStart) * alpha;
+    }
+
+    mShown = qBound(0.0, mShown, double(MAX_RPM_VALUE));
+    return qRound(mShown);
+}
+
+
+void RpmGauge::setInterpolation(bool enable)
+{
+    LOG (LOG_RPM, "%s - interpolation %s", CLASS_INFO, enable ? "enabled" : "disabled");
+
+    mInterpolation = enable;
+}
+
+
+void RpmGauge::setExtrapolation(int horizon)
+{
+    LOG (LOG_RPM, "%s - extrapolation horizon %d ms", CLASS_INFO, horizon);
+
+    mHorizon = qBound(0, horizon, GAUGE_MAX_HORIZON) * 1000;
+}
+
+
+void RpmGauge::paintEvent(QPaintEvent *event)
+{
+    QPainter p(this);
+    QRect r = event->rect();
+
+    if (testAttribute(Qt::WA_OpaquePaintEvent))
+        p.fillRect(r, palette().brush(backgroundRole()));
+
+    /* painter is clipped to dirty region, draw only what intersects it */
+    for (int i = 0; i < mDots; ++i) {
+        QRect dot(dotPositions[i], QSize(DOT_SIZE, DOT_SIZE));
+        if (event->region().intersects(dot))
+            p.drawPixmap(dot.topLeft(), dotPixmaps.at(i));
+    }
+
+    /* dial artwork covers lit dots (as in former layout) */
+    if (hasBackground)
+        p.drawPixmap(r, background, r);
+
+    QRect pin = pintop.adjusted(-PINTOP_WIDTH, -PINTOP_WIDTH, PINTOP_WIDTH, PINTOP_WIDTH).toAlignedRect();
+    if (event->region().intersects(needleRect(mValue)) || event->region().intersects(pin)) {
+        p.setRenderHint(QPainter::Antialiasing, mSmoothing);
+        p.setPen(pintopPen);
+        p.drawEllipse(pintop);
+        p.setPen(needlePen);
+        p.drawLine(needleLine(mValue));
+        p.setRenderHint(QPainter::Antialiasing, false);
+    }
+
+    p.drawPixmap(r, overlay, r);
+}
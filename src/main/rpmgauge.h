@@ -0,0 +1,104 @@
+/**
+ * \class RpmGauge
+ *
+ * \brief
+ *
+ * This class paints the whole rpm dial (lit dots, dial artwork, needle,
+ * captions and dark dots) in one paintEvent. Static layers are rendered
+ * once to cached pixmaps, value changes invalidate only rects of the
+ * needle and of dots which changed state.
+ *
+ * Timestamped samples can be interpolated at display rate: the needle
+ * moves from the shown value to the new sample over one sample interval,
+ * optionally extrapolated along the last slope (up to horizon) to hide
+ * pipeline latency. Cost per frame is constant.
+ *
+ * \version 1.0
+ *
+ * \date 2019/02/24 16:05:33
+ *
+ */
+#ifndef RPMGAUGE_H
+#define RPMGAUGE_H
+
+#include <QWidget>
+#include <QPixmap>
+#include <QVector>
+#include <QPen>
+#include <QRect>
+#include <QRegion>
+#include <QLineF>
+
+#define GAUGE_SIZE          301
+#define GAUGE_DOTS          23
+#define GAUGE_MAX_HORIZON   200     /* max extrapolation horizon [ms] */
+#define GAUGE_NEEDLE_PARTS  8       /* needle is invalidated as rects of its parts (partial repaint) */
+
+class RpmGauge : public QWidget
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief RpmGauge - creates a gauge and renders static layers
+     * @param parent - parent widget
+     */
+    explicit RpmGauge(QWidget *parent = 0);
+
+    /// sets rpm value, invalidates changed region only
+    void setValue(int value);
+    /// returns displayed rpm value
+    int getValue(void);
+    /// enables/disables antialiasing of the needle
+    void setSmoothing(bool enable);
+    /// stores timestamped sample [us] for interpolation
+    void addSample(int value, qint64 time);
+    /// returns interpolated value for display time [us]
+    int interpolate(qint64 now);
+    /// enables/disables interpolation (samples are displayed directly)
+    void setInterpolation(bool enable);
+    /// sets max extrapolation horizon [ms], 0 disables extrapolation
+    void setExtrapolation(int horizon);
+    /// enables/disables partial repaint (gauge paints its background, needle parts are invalidated)
+    void setPartialRepaint(bool enable);
+
+protected:
+    void paintEvent(QPaintEvent *event);
+    void changeEvent(QEvent *event);
+
+private:
+    /// renders dial artwork (under the needle) and captions with dark dots (over the needle)
+    void renderLayers(void);
+    /// returns number of lit dots for value
+    int litDots(int value);
+    /// returns needle line for value
+    QLineF needleLine(int value);
+    /// returns rect covered by needle for value
+    QRect needleRect(int value);
+    /// returns region to invalidate when needle of value is drawn or erased
+    QRegion needleRegion(int value);
+    /// gauge is opaque in partial repaint mode if its background is opaque
+    void updateOpaque(void);
+
+    QPixmap background; /// - cached dial artwork (between lit dots and needle)
+    bool hasBackground; /// - keeps information whether dial artwork was found
+    QPixmap overlay; /// - cached layer over needle (captions, dark dots)
+    QVector<QPixmap> dotPixmaps; /// - lit dots scaled to their size
+    QPen needlePen, pintopPen; /// - cached pens of needle
+    QPointF pivot; /// - needle rotation point
+    QRectF pintop; /// - pintop rect
+    double needleLength; /// - needle length [px]
+    int mValue; /// - displayed rpm value
+    int mDots; /// - number of lit dots
+    bool mSmoothing; /// - keeps information whether needle is antialiased
+    bool mPartial; /// - partial repaint mode
+    bool mInterpolation; /// - keeps information whether samples are interpolated
+    qint64 mHorizon; /// - max extrapolation horizon [us]
+    qint64 mTime[2]; /// - times of two latest samples [us]
+    double mSample[2]; /// - two latest samples
+    double mStart; /// - shown value when latest sample arrived
+    double mShown; /// - last interpolated value
+    int mSamples; /// - number of stored samples (up to 2)
+};
+
+#endif // RPMGAUGE_H
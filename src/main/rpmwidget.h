@@ -19,12 +19,7 @@
 
 #include <QObject>
 #include <QWidget>
-#include <QLabel>
-#include <QGraphicsScene>
-#include <QColor>
-#include <QBrush>
-#include <QPen>
-#include <QGraphicsEllipseItem>
+#include "rpmgauge.h"
 
 namespace Ui {
     class RpmWidget;
@@ -48,22 +43,46 @@ public slots:
      * @param value - method argument passing current rpm value data
      */
     void updateWidget(int value);
+    /**
+     * @brief addSample - This method stores timestamped rpm sample for interpolation
+     * @param value - rpm value
+     * @param time - arrival time of value [us]
+     */
+    void addSample(int value, qint64 time);
+    /**
+     * @brief advance - This method updates widget by value interpolated for display time
+     * @param now - display time [us]
+     */
+    void advance(qint64 now);
+    /**
+     * @brief setInterpolation - This method enables/disables interpolation of samples
+     * @param enable - true to interpolate samples at display rate
+     */
+    void setInterpolation(bool enable);
+    /**
+     * @brief setExtrapolation - This method sets max extrapolation horizon
+     * @param horizon - horizon [ms], 0 disables extrapolation
+     */
+    void setExtrapolation(int horizon);
+    /**
+     * @brief setSmoothing - This method enables/disables antialiasing of the indicator
+     * @param enable - true for full quality
+     */
+    void setSmoothing(bool enable);
+    /**
+     * @brief setPartialRepaint - This method enables/disables partial repaint mode of the gauge
+     * @param enable - true if gauge paints its background and invalidates needle parts only
+     */
+    void setPartialRepaint(bool enable);
 
 private:
     /**
-     * @brief initWidget - This method is used to initialize scene
+     * @brief initWidget - This method is used to initialize gauge
      */
     void initWidget(void);
-    /**
-     * @brief drawLine - This method is used to draw the indicator
-     * @param value - method argument passing current rpm value data
-     */
-    void drawLine(int value);
 
-    int currentNoOfDots; /// - keeps information of number of dots needed to paint
-    QList<QLabel *> dots; /// - keeps QLabel pointers to dots
-    QGraphicsScene *scene; /// - is a pointer to object of QGraphicScene class
-    QString mainColor; /// - keeps information about main theme color
+    int currentValue; /// - keeps information of displayed rpm value
+    RpmGauge *gauge; /// - pointer to painted dial (dots, needle)
     Ui::RpmWidget *rpm; /// - pointer to UI of RpmWidget
 
 };
@@ -0,0 +1,388 @@
+#include <QPainter>
+#include <QPaintEvent>
+#include <QPolygonF>
+#include <QCoreApplication>
+#include <QtMath>
+#include "segmentdisplay.h"
+#include "../common/logger.h"
+
+#define CLASS_INFO          "segment display"
+
+/* segments of glyph */
+#define SEG_A               0x01    /* top */
+#define SEG_B               0x02    /* upper right */
+#define SEG_C               0x04    /* lower right */
+#define SEG_D               0x08    /* bottom */
+#define SEG_E               0x10    /* lower left */
+#define SEG_F               0x20    /* upper left */
+#define SEG_G               0x40    /* middle */
+
+static const quint8 digitSegments[10] = {
+    SEG_A | SEG_B | SEG_C | SEG_D | SEG_E | SEG_F,          /* 0 */
+    SEG_B | SEG_C,                                          /* 1 */
+    SEG_A | SEG_B | SEG_D | SEG_E | SEG_G,                  /* 2 */
+    SEG_A | SEG_B | SEG_C | SEG_D | SEG_G,                  /* 3 */
+    SEG_B | SEG_C | SEG_F | SEG_G,                          /* 4 */
+    SEG_A | SEG_C | SEG_D | SEG_F | SEG_G,                  /* 5 */
+    SEG_A | SEG_C | SEG_D | SEG_E | SEG_F | SEG_G,          /* 6 */
+    SEG_A | SEG_B | SEG_C,                                  /* 7 */
+    SEG_A | SEG_B | SEG_C | SEG_D | SEG_E | SEG_F | SEG_G,  /* 8 */
+    SEG_A | SEG_B | SEG_C | SEG_D | SEG_F | SEG_G           /* 9 */
+};
+
+QHash<QPair<quint64, QRgb>, QPixmap> SegmentDisplay::sAtlas;
+quint64 SegmentDisplay::sHits = 0;
+quint64 SegmentDisplay::sMisses = 0;
+
+/* pixmaps must be released before application object */
+static void releaseAtlas(void)
+{
+    SegmentDisplay::clearCache();
+}
+
+
+SegmentDisplay::SegmentDisplay(QWidget *parent)
+    : QFrame(parent)
+{
+    LOG (LOG_MAINWINDOW, "%s - in constructor", CLASS_INFO);
+
+    mDigits = SEGMENT_DEFAULT_DIGITS;
+    mSmallPoint = false;
+    mPartial = false;
+    mValue = 0;
+    mSegLen = mAdvance = 0;
+    mXOffset = mYOffset = 0;
+
+    Cell blank = { ' ', false };
+    mCells.fill(blank, mDigits);
+    layoutCells();
+}
+
+
+SegmentDisplay::~SegmentDisplay()
+{
+
+}
+
+
+int SegmentDisplay::digitCount(void) const
+{
+    return mDigits;
+}
+
+
+void SegmentDisplay::setDigitCount(int count)
+{
+    count = qBound(1, count, SEGMENT_MAX_DIGITS);
+    if (count == mDigits)
+        return;
+
+    mDigits = count;
+    Cell blank = { ' ', false };
+    mCells.fill(blank, mDigits);
+    toCells(mText, mCells);
+    layoutCells();
+    update();
+}
+
+
+bool SegmentDisplay::smallDecimalPoint(void) const
+{
+    return mSmallPoint;
+}
+
+
+void SegmentDisplay::setSmallDecimalPoint(bool enable)
+{
+    if (enable == mSmallPoint)
+        return;
+
+    mSmallPoint = enable;
+    Cell blank = { ' ', false };
+    mCells.fill(blank, mDigits);
+    toCells(mText, mCells);
+    layoutCells();
+    update();
+}
+
+
+double SegmentDisplay::value(void) const
+{
+    return mValue;
+}
+
+
+int SegmentDisplay::intValue(void) const
+{
+    return qRound(mValue);
+}
+
+
+void SegmentDisplay::setPartialRepaint(bool enable)
+{
+    mPartial = enable;
+    updateOpaque();
+    update();
+}
+
+
+void SegmentDisplay::updateOpaque(void)
+{
+    /* translucent background (over rpm gauge) needs parents painted under it */
+    setAttribute(Qt::WA_OpaquePaintEvent, mPartial && palette().brush(backgroundRole()).isOpaque());
+}
+
+
+void SegmentDisplay::display(const QString &text)
+{
+    if (setText(text))
+        mValue = text.trimmed().toDouble();
+}
+
+
+void SegmentDisplay::display(int value)
+{
+    if (setText(QString::number(value)))
+        mValue = value;
+}
+
+
+void SegmentDisplay::display(double value)
+{
+    /* use as many significant digits as fit in cells */
+    for (int precision = mDigits; precision > 0; --precision) {
+        if (setText(QString::number(value, 'g', precision))) {
+            mValue = value;
+            return;
+        }
+    }
+
+    LOG (LOG_MAINWINDOW, "%s - %f does not fit in %d digits", CLASS_INFO, value, mDigits);
+}
+
+
+bool SegmentDisplay::setText(const QString &text)
+{
+    QVector<Cell> cells;
+
+    if (!toCells(text, cells))
+        return false;
+
+    /* repaint only cells which changed */
+    for (int i = 0; i < mDigits; ++i) {
+        if (cells.at(i) != mCells.at(i))
+            update(cellRect(i));
+    }
+    mCells = cells;
+    mText = text;
+
+    return true;
+}
+
+
+bool SegmentDisplay::toCells(const QString &text, QVector<Cell> &cells) const
+{
+    QVector<Cell> result;
+    result.reserve(mDigits);
+
+    for (int i = 0; i < text.length(); ++i) {
+        char c = text.at(i).toLatin1();
+        Cell cell = { c, false };
+
+        if (c == '.' && mSmallPoint) {
+            if (!result.isEmpty() && !result.last().point) {
+                result.last().point = true;
+                continue;
+            }
+            cell.c = ' ';
+            cell.point = true;
+        } else if (!((c >= '0' && c <= '9') || c == '-' || c == '.' || c == ':')) {
+            cell.c = ' ';
+        }
+        result.append(cell);
+    }
+
+    if (result.size() > mDigits)
+        return false;
+
+    /* right aligned */
+    Cell blank = { ' ', false };
+    cells.fill(blank, mDigits);
+    for (int i = 0; i < result.size(); ++i)
+        cells[mDigits - result.size() + i] = result.at(i);
+
+    return true;
+}
+
+
+void SegmentDisplay::layoutCells(void)
+{
+    /* geometry of QLCDNumber (digit is segLen wide, 2 * segLen high) */
+    int digitSpace = mSmallPoint ? 2 : 1;
+    int xSegLen = width() * 5 / (mDigits * (5 + digitSpace) + digitSpace);
+    int ySegLen = height() * 5 / 12;
+
+    mSegLen = qMax(0, qMin(xSegLen, ySegLen));
+    mAdvance = mSegLen * (5 + digitSpace) / 5;
+    mXOffset = (width() - mDigits * mAdvance + mSegLen / 5) / 2;
+    mYOffset = (height() - mSegLen * 2) / 2;
+}
+
+
+QRect SegmentDisplay::cellRect(int index) const
+{
+    return QRect(mXOffset + mAdvance * index, mYOffset, mAdvance, mSegLen * 2 + 1);
+}
+
+
+void SegmentDisplay::paintEvent(QPaintEvent *event)
+{
+    QPainter painter(this);
+    if (testAttribute(Qt::WA_OpaquePaintEvent))
+        painter.fillRect(event->rect(), palette().brush(backgroundRole()));
+    drawFrame(&painter);
+
+    if (mSegLen < 2)
+        return;
+
+    QRgb color = palette().color(QPalette::WindowText).rgba();
+    qreal ratio = devicePixelRatioF();
+
+    for (int i = 0; i < mDigits; ++i) {
+        const Cell &cell = mCells.at(i);
+        if (cell.c == ' ' && !cell.point)
+            continue;
+
+        QRect rect = cellRect(i);
+        if (!event->region().intersects(rect))
+            continue;
+
+        painter.drawPixmap(rect.topLeft(), glyph(cell, mSegLen, mAdvance, color, ratio));
+    }
+}
+
+
+void SegmentDisplay::resizeEvent(QResizeEvent *event)
+{
+    layoutCells();
+    QFrame::resizeEvent(event);
+}
+
+
+void SegmentDisplay::changeEvent(QEvent *event)
+{
+    /* new color - all cells use other glyphs */
+    if (event->type() == QEvent::PaletteChange || event->type() == QEvent::StyleChange) {
+        updateOpaque();
+        update();
+    }
+
+    QFrame::changeEvent(event);
+}
+
+
+const QPixmap &SegmentDisplay::glyph(const Cell &cell, int segLen, int advance, QRgb color, qreal ratio)
+{
+    QPair<quint64, QRgb> key((quint64(quint8(cell.c)) | (quint64(cell.point) << 8) |
+                              (quint64(segLen & 0xffff) << 9) | (quint64(advance & 0xffff) << 25) |
+                              (quint64(qRound(ratio * 100)) << 41)), color);
+
+    QHash<QPair<quint64, QRgb>, QPixmap>::const_iterator it = sAtlas.constFind(key);
+    if (it != sAtlas.constEnd()) {
+        sHits++;
+        return it.value();
+    }
+
+    LOG (LOG_MAINWINDOW, "%s - rendering glyph '%c' %d px", CLASS_INFO, cell.c, segLen);
+
+    if (sAtlas.isEmpty())
+        qAddPostRoutine(releaseAtlas);
+    sMisses++;
+
+    int height = segLen * 2 + 1;
+    QPixmap image(qCeil(advance * ratio), qCeil(height * ratio));
+    image.setDevicePixelRatio(ratio);
+    image.fill(Qt::transparent);
+
+    QPainter painter(&image);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setPen(Qt::NoPen);
+    painter.setBrush(QColor::fromRgba(color));
+
+    /* flat segments, thickness is 1/5 of segment length (as QLCDNumber) */
+    qreal len = segLen;
+    qreal h = qMax(1.0, len / 10);
+    qreal g = h / 4;
+    quint8 segments = 0;
+
+    if (cell.c >= '0' && cell.c <= '9')
+        segments = digitSegments[cell.c - '0'];
+    else if (cell.c == '-')
+        segments = SEG_G;
+
+    for (int s = 0; s < 7; ++s) {
+        if (!(segments & (1 << s)))
+            continue;
+
+        QPolygonF polygon;
+        qreal x = 0, y = 0, y0 = 0, y1 = 0;
+        bool horizontal = false;
+
+        switch (1 << s) {
+        case SEG_A: horizontal = true; y = h; break;
+        case SEG_G: horizontal = true; y = len; break;
+        case SEG_D: horizontal = true; y = 2 * len - h; break;
+        case SEG_F: x = h; y0 = 0; y1 = len; break;
+        case SEG_B: x = len - h; y0 = 0; y1 = len; break;
+        case SEG_E: x = h; y0 = len; y1 = 2 * len; break;
+        case SEG_C: x = len - h; y0 = len; y1 = 2 * len; break;
+        }
+
+        if (horizontal)
+            polygon << QPointF(g, y) << QPointF(g + h, y - h) << QPointF(len - g - h, y - h)
+                    << QPointF(len - g, y) << QPointF(len - g - h, y + h) << QPointF(g + h, y + h);
+        else
+            polygon << QPointF(x, y0 + g) << QPointF(x + h, y0 + g + h) << QPointF(x + h, y1 - g - h)
+                    << QPointF(x, y1 - g) << QPointF(x - h, y1 - g - h) << QPointF(x - h, y0 + g + h);
+
+        painter.drawPolygon(polygon);
+    }
+
+    /* decimal point and colon */
+    qreal dot = 2 * h;
+    if (cell.c == '.')
+        painter.drawRect(QRectF(len / 2 - h, 2 * len - dot, dot, dot));
+    if (cell.c == ':') {
+        painter.drawRect(QRectF(len / 2 - h, len / 2 - h, dot, dot));
+        painter.drawRect(QRectF(len / 2 - h, 3 * len / 2 - h, dot, dot));
+    }
+    if (cell.point)
+        painter.drawRect(QRectF(len + (advance - len - dot) / 2, 2 * len - dot, dot, dot));
+    painter.end();
+
+    return sAtlas.insert(key, image).value();
+}
+
+
+quint64 SegmentDisplay::getCacheHits(void)
+{
+    return sHits;
+}
+
+
+quint64 SegmentDisplay::getCacheMisses(void)
+{
+    return sMisses;
+}
+
+
+void SegmentDisplay::resetCacheStats(void)
+{
+    sHits = sMisses = 0;
+}
+
+
+void SegmentDisplay::clearCache(void)
+{
+    sAtlas.clear();
+}
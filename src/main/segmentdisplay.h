@@ -0,0 +1,138 @@
+/**
+ * \class SegmentDisplay
+ *
+ * \brief
+ *
+ * This class is a numeric seven-segment display (subset of QLCDNumber
+ * interface, flat segments). Glyphs are rendered once to a process-wide
+ * pixmap atlas keyed by character, size, color and device pixel ratio.
+ * display() compares the new text with the shown one and repaints only
+ * cells of digits which changed, a paint is a drawPixmap per cell.
+ *
+ * Digit color is taken from palette (WindowText), so it can be set by
+ * style sheet "color" or by QPalette (Threshold).
+ *
+ * In partial repaint mode display with opaque background paints the
+ * background itself and is opaque, so parents are not repainted under it.
+ *
+ * \version 1.0
+ *
+ * \date 2019/03/08 19:22:47
+ *
+ */
+#ifndef SEGMENTDISPLAY_H
+#define SEGMENTDISPLAY_H
+
+#include <QFrame>
+#include <QColor>
+#include <QHash>
+#include <QPair>
+#include <QPixmap>
+#include <QString>
+#include <QVector>
+
+#define SEGMENT_DEFAULT_DIGITS      5
+#define SEGMENT_MAX_DIGITS          99
+
+class SegmentDisplay : public QFrame
+{
+    Q_OBJECT
+    Q_PROPERTY(int digitCount READ digitCount WRITE setDigitCount)
+    Q_PROPERTY(bool smallDecimalPoint READ smallDecimalPoint WRITE setSmallDecimalPoint)
+    Q_PROPERTY(double value READ value WRITE display)
+    Q_PROPERTY(int intValue READ intValue WRITE display)
+
+public:
+    /**
+     * @brief SegmentDisplay - constructs display with SEGMENT_DEFAULT_DIGITS digits
+     * @param parent - QWidget parent
+     */
+    explicit SegmentDisplay(QWidget *parent = 0);
+    ~SegmentDisplay();
+
+    /// returns/sets number of digit cells
+    int digitCount(void) const;
+    void setDigitCount(int count);
+    /// returns/sets whether decimal point is drawn between cells
+    bool smallDecimalPoint(void) const;
+    void setSmallDecimalPoint(bool enable);
+    /// returns displayed value
+    double value(void) const;
+    int intValue(void) const;
+    /// enables/disables partial repaint mode
+    void setPartialRepaint(bool enable);
+
+    /// returns number of cell paints served from atlas and number of rendered glyphs
+    static quint64 getCacheHits(void);
+    static quint64 getCacheMisses(void);
+    /// resets atlas counters
+    static void resetCacheStats(void);
+    /// releases glyph atlas
+    static void clearCache(void);
+
+public slots:
+    /// displays text (digits, '-', '.', ':' and space), longer text is ignored
+    void display(const QString &text);
+    /// displays integer value
+    void display(int value);
+    /// displays value with as many decimals as fit in cells
+    void display(double value);
+
+protected:
+    /**
+     * @brief paintEvent - reimplemented method, draws frame and glyphs of cells in dirty region
+     */
+    void paintEvent(QPaintEvent *event);
+    /**
+     * @brief resizeEvent - reimplemented method, recalculates cell geometry
+     */
+    void resizeEvent(QResizeEvent *event);
+    /**
+     * @brief changeEvent - reimplemented method, repaints all cells when palette or style changed
+     */
+    void changeEvent(QEvent *event);
+
+private:
+    /// displayed character of cell, decimal point is kept with digit before it (small point)
+    struct Cell {
+        char c; /// - character
+        bool point; /// - small decimal point after character
+
+        bool operator!=(const Cell &other) const { return c != other.c || point != other.point; }
+    };
+
+    /// shows text, repaints changed cells, returns false if text does not fit
+    bool setText(const QString &text);
+    /// splits text to cells, returns false if text does not fit
+    bool toCells(const QString &text, QVector<Cell> &cells) const;
+    /// recalculates segment length and cell positions from widget size
+    void layoutCells(void);
+    /// returns rectangle of cell
+    QRect cellRect(int index) const;
+    /// display is opaque in partial repaint mode if its background is opaque
+    void updateOpaque(void);
+    /**
+     * @brief glyph - returns cached glyph, renders it on first use
+     * @param cell - character and decimal point
+     * @param segLen - segment length [px]
+     * @param advance - cell width [px]
+     * @param color - segment color
+     * @param ratio - device pixel ratio
+     */
+    static const QPixmap &glyph(const Cell &cell, int segLen, int advance, QRgb color, qreal ratio);
+
+    QVector<Cell> mCells; /// - displayed cells
+    QString mText; /// - displayed text
+    int mDigits; /// - number of cells
+    bool mSmallPoint; /// - keeps information whether decimal point is drawn between cells
+    bool mPartial; /// - partial repaint mode
+    double mValue; /// - displayed value
+    int mSegLen; /// - segment length [px]
+    int mAdvance; /// - cell width [px]
+    int mXOffset, mYOffset; /// - position of first cell
+
+    static QHash<QPair<quint64, QRgb>, QPixmap> sAtlas; /// - glyphs of all displays
+    static quint64 sHits, sMisses; /// - atlas counters
+};
+
+#endif // SEGMENTDISPLAY_H
@@ -0,0 +1,113 @@
+#include <QElapsedTimer>
+#include "theme.h"
+#include "../common/parameters.h"
+#include "../common/logger.h"
+
+#define CLASS_INFO          "theme"
+
+
+Theme::Theme(QWidget *root, QObject *parent)
+    : QObject(parent), mRoot(root)
+{
+    LOG (LOG_MAINWINDOW, "%s - in constructor", CLASS_INFO);
+
+    /* background roles of every contrast value, other roles are inherited */
+    mPalettes.resize(THEME_CONTRAST_LEVELS);
+    for (int i = 0; i < THEME_CONTRAST_LEVELS; ++i) {
+        QColor color(i, i, i);
+
+        mPalettes[i].setColor(QPalette::Window, color);
+        mPalettes[i].setColor(QPalette::Base, color);
+        mPalettes[i].setColor(QPalette::Button, color);
+    }
+
+    mContrast = DEFAULT_BACKG_COLOR;
+    /* font of ui files is kept until font size is set */
+    mFontSize = 0;
+    mPaletteDirty = true;
+    mFontDirty = false;
+    mSwitchTime = 0;
+
+    mApplyTimer.setSingleShot(true);
+    mApplyTimer.setInterval(0);
+    connect (&mApplyTimer, &QTimer::timeout, this, &Theme::apply);
+
+    mRoot->setAutoFillBackground(true);
+    apply();
+}
+
+
+int Theme::getContrast(void)
+{
+    return mContrast;
+}
+
+
+int Theme::getFontSize(void)
+{
+    return mFontSize;
+}
+
+
+qint64 Theme::getSwitchTime(void)
+{
+    return mSwitchTime;
+}
+
+
+void Theme::setContrast(int value)
+{
+    value = qBound(0, value, THEME_CONTRAST_LEVELS - 1);
+    if (value == mContrast)
+        return;
+
+    mContrast = value;
+    mPaletteDirty = true;
+    mApplyTimer.start();
+}
+
+
+void Theme::setFontSize(int size)
+{
+    if (size <= 0 || size == mFontSize)
+        return;
+
+    mFontSize = size;
+    mFontDirty = true;
+    mApplyTimer.start();
+}
+
+
+void Theme::apply(void)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    if (mPaletteDirty)
+        mRoot->setPalette(mPalettes.at(mContrast));
+    if (mFontDirty)
+        mRoot->setFont(font(mFontSize));
+    mPaletteDirty = mFontDirty = false;
+
+    mSwitchTime = timer.nsecsElapsed() / 1000;
+
+    LOG (LOG_MAINWINDOW, "%s - contrast %d, font %d pt applied in %lld us", CLASS_INFO,
+         mContrast, mFontSize, mSwitchTime);
+}
+
+
+const QFont &Theme::font(int size)
+{
+    QHash<int, QFont>::iterator it = mFonts.find(size);
+
+    if (it == mFonts.end()) {
+        QFont f = mRoot->font();
+
+        f.setPointSize(size);
+        f.setItalic(true);
+        f.setBold(true);
+        it = mFonts.insert(size, f);
+    }
+
+    return it.value();
+}
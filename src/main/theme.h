@@ -0,0 +1,74 @@
+/**
+ * \class Theme
+ *
+ * \brief
+ *
+ * This class applies background contrast and font size to the widget tree.
+ * Palettes of all contrast values are computed once at construction and
+ * fonts once per size, then they are set on the root widget and propagate
+ * to children (QPalette/QFont propagation), so a theme switch does not
+ * re-polish style sheets of the whole tree. Requests coming faster than
+ * the event loop (slider dragging) are coalesced to one switch.
+ *
+ * \version 1.0
+ *
+ * \date 2019/03/04 21:05:33
+ *
+ */
+#ifndef THEME_H
+#define THEME_H
+
+#include <QObject>
+#include <QWidget>
+#include <QPalette>
+#include <QFont>
+#include <QHash>
+#include <QVector>
+#include <QTimer>
+
+#define THEME_CONTRAST_LEVELS   256
+
+class Theme : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Theme - creates theme and computes palettes
+     * @param root - widget which palette and font propagate to its children
+     * @param parent - parent object
+     */
+    explicit Theme(QWidget *root, QObject *parent = 0);
+
+    /// returns background contrast (gray level 0 - 255)
+    int getContrast(void);
+    /// returns font size [pt], 0 if font of ui files is used
+    int getFontSize(void);
+    /// returns duration of last theme switch [us]
+    qint64 getSwitchTime(void);
+
+public slots:
+    /// sets background contrast, applied on next event loop pass
+    void setContrast(int value);
+    /// sets font size [pt], applied on next event loop pass
+    void setFontSize(int size);
+
+private slots:
+    /// applies pending palette and font to root widget
+    void apply(void);
+
+private:
+    /// returns font of size (computed once)
+    const QFont &font(int size);
+
+    QWidget *mRoot; /// - root of themed widget tree
+    QVector<QPalette> mPalettes; /// - palettes of all contrast values
+    QHash<int, QFont> mFonts; /// - fonts of used sizes
+    int mContrast; /// - background contrast
+    int mFontSize; /// - font size [pt]
+    bool mPaletteDirty, mFontDirty; /// - keeps information whether palette/font has to be applied
+    qint64 mSwitchTime; /// - duration of last theme switch [us]
+    QTimer mApplyTimer; /// - coalesces theme requests
+};
+
+#endif // THEME_H
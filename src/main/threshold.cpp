@@ -0,0 +1,127 @@
+#include "threshold.h"
+#include "../common/logger.h"
+
+#define CLASS_INFO          "threshold"
+
+/* colors and frame widths of levels */
+static const char * const levelColors[LEVEL_COUNT] = {
+    "#00ffc1",
+    "#ffff99",
+    "#ff4d4d"
+};
+static const int levelLineWidths[LEVEL_COUNT] = { 2, 4, 4 };
+
+
+Threshold::Threshold()
+{
+    mLimits.warning = mLimits.alarm = mLimits.hysteresis = 0;
+    mValue = 0;
+    mLevel = LEVEL_NORMAL;
+    mTransitions = 0;
+}
+
+
+void Threshold::setLimits(const ThresholdLimits &limits)
+{
+    LOG (LOG_MAINWINDOW, "%s - limits %.1f/%.1f, hysteresis %.1f", CLASS_INFO,
+         limits.warning, limits.alarm, limits.hysteresis);
+
+    mLimits = limits;
+    mLimits.hysteresis = qAbs(limits.hysteresis);
+
+    /* classify last value again without hysteresis */
+    int level = mLevel;
+    mLevel = LEVEL_NORMAL;
+    if (!update(mValue) && level != mLevel)
+        apply();
+}
+
+
+const ThresholdLimits &Threshold::getLimits(void) const
+{
+    return mLimits;
+}
+
+
+void Threshold::addWidget(QFrame *widget)
+{
+    mWidgets.append(widget);
+    apply();
+}
+
+
+bool Threshold::update(float value)
+{
+    mValue = value;
+    if (!mLimits.isEnabled())
+        return false;
+
+    /* falling limits are checked as rising limits of negated value */
+    float sign = mLimits.isFalling() ? -1 : 1;
+    float v = sign * value;
+    float warning = sign * mLimits.warning;
+    float alarm = sign * mLimits.alarm;
+    float h = mLimits.hysteresis;
+    int level = mLevel;
+
+    /* enter higher level as soon as limit is crossed */
+    int up = (v > alarm) ? LEVEL_ALARM : (v > warning) ? LEVEL_WARNING : LEVEL_NORMAL;
+    /* leave level only when value is below limit by hysteresis */
+    int down = (v > alarm - h) ? LEVEL_ALARM : (v > warning - h) ? LEVEL_WARNING : LEVEL_NORMAL;
+
+    if (up > level)
+        level = up;
+    else if (down < level)
+        level = down;
+
+    if (level == mLevel)
+        return false;
+
+    mLevel = level;
+    mTransitions++;
+    apply();
+
+    return true;
+}
+
+
+int Threshold::getLevel(void) const
+{
+    return mLevel;
+}
+
+
+quint32 Threshold::getTransitions(void) const
+{
+    return mTransitions;
+}
+
+
+void Threshold::apply(void)
+{
+    const QPalette &pal = palette(mLevel);
+
+    for (int i = 0; i < mWidgets.size(); ++i) {
+        QFrame *widget = mWidgets.at(i);
+
+        widget->setPalette(pal);
+        /* frames are drawn as plain box in palette color */
+        if (widget->frameShape() == QFrame::Box)
+            widget->setLineWidth(levelLineWidths[mLevel]);
+    }
+}
+
+
+const QPalette &Threshold::palette(int level)
+{
+    static QPalette palettes[LEVEL_COUNT];
+    static bool ready = false;
+
+    if (!ready) {
+        for (int i = 0; i < LEVEL_COUNT; ++i)
+            palettes[i].setColor(QPalette::WindowText, QColor(levelColors[i]));
+        ready = true;
+    }
+
+    return palettes[level];
+}
@@ -0,0 +1,71 @@
+/**
+ * \class Threshold
+ *
+ * \brief
+ *
+ * This class keeps warning state of one displayed value. Level goes up
+ * when value crosses a limit and goes back only when value returns past
+ * the limit by hysteresis, so noise around a limit does not make widgets
+ * flicker. Bound widgets are restyled only on level transitions, with
+ * palettes computed once for every level (no stylesheet re-polish).
+ *
+ * Limits are rising (warning < alarm, for example temperature) or falling
+ * (warning > alarm, for example voltage). Limits 0/0 disable the warning.
+ *
+ * \version 1.0
+ *
+ * \date 2019/03/02 17:40:12
+ *
+ */
+#ifndef THRESHOLD_H
+#define THRESHOLD_H
+
+#include <QFrame>
+#include <QPalette>
+#include <QVector>
+#include "../common/limits.h"
+
+enum ThresholdLevel {
+    LEVEL_NORMAL = 0,
+    LEVEL_WARNING,
+    LEVEL_ALARM,
+    LEVEL_COUNT
+};
+
+
+class Threshold
+{
+
+public:
+    Threshold();
+
+    /// sets limits and restyles widgets if level changed
+    void setLimits(const ThresholdLimits &limits);
+    const ThresholdLimits &getLimits(void) const;
+    /// binds widget (frame or LCD) styled by level
+    void addWidget(QFrame *widget);
+    /**
+     * @brief update - checks value against limits
+     * @param value - displayed value
+     * @return true if level changed (widgets were restyled)
+     */
+    bool update(float value);
+    /// returns current ThresholdLevel
+    int getLevel(void) const;
+    /// returns number of level transitions
+    quint32 getTransitions(void) const;
+
+private:
+    /// restyles bound widgets for current level
+    void apply(void);
+    /// returns palette of level (computed once)
+    static const QPalette &palette(int level);
+
+    ThresholdLimits mLimits; /// - warning and alarm limits
+    float mValue; /// - last checked value
+    int mLevel; /// - current ThresholdLevel
+    quint32 mTransitions; /// - number of level transitions
+    QVector<QFrame *> mWidgets; /// - widgets styled by level
+};
+
+#endif // THRESHOLD_H
@@ -18,6 +18,9 @@
 #include "../common/parameters.h"
 #include "../common/logger.h"
 #include "../settings/parser.h"
+#include "../main/renderscheduler.h"
+#include "../main/rpmgauge.h"
+#include "../stats/stripchart.h"
 
 #define CLASS_INFO      "settings"
 #define FILE_NAME       "settings.conf"
@@ -33,6 +36,13 @@ Settings::Settings(QWidget *parent, Connections *connection) :
 
     settings->setupUi(this);
     con = connection;
+    mRenderRate = RENDER_DEFAULT_RATE;
+    mInterpolation = true;
+    mExtrapolation = 0;
+    mPartialRepaint = false;
+    mChartWindow = CHART_DEFAULT_WINDOW;
+    for (int i = 0; i < CHANNEL_COUNT; ++i)
+        mLimits[i] = defaultLimits[i];
 
     /* set CAN baud rates */
     connectionsFillCanBaudComboBox();
@@ -103,6 +113,9 @@ void Settings::initializeSignalsAndSlots(void)
     /* signal activated when CAN data check box clicked */
     connect (settings->canDataCheck, &QCheckBox::stateChanged,
                 [=](int state) { onConnectionsSetCanCheckBox(state); });
+    /* signal activated when overlay check box clicked */
+    connect (settings->overlayCheck, &QCheckBox::stateChanged,
+                [=](int state) { emit updateOverlay(state); });
     /* signal activated to enable CAN output to console */
     connect (this, &Settings::enableCanToConsole, con,
                 [=](bool enable) { con->setCanDataToConsole(enable); });
@@ -612,6 +625,141 @@ void Settings::readConfigFile()
     key2 = conf_get_value(key, &value);
     if (key != -1 && key2 != 0)
         onConnectionsSetCanCheckBox(atoi(value));
+    key = conf_find_key(GLOBAL, "Computed channels", NULL);
+    if (key != -1)
+        readComputedChannels(key);
+    key = conf_find_key(GLOBAL, "Capture", NULL);
+    if (key != -1)
+        readCaptureSettings(key);
+    key = conf_find_key(GLOBAL, "Display", NULL);
+    if (key != -1)
+        readDisplaySettings(key);
+    key = conf_find_key(GLOBAL, "Limits", NULL);
+    if (key != -1)
+        readLimits(key);
+}
+
+
+void Settings::readDisplaySettings(int key)
+{
+    LOG (LOG_SETTINGS, "%s - reading display settings", CLASS_INFO);
+
+    int item = 0;
+    char *name, *value;
+
+    while (conf_list_items(key, &item, &name)) {
+        if (!conf_get_value(item, &value))
+            continue;
+
+        if (strcmp(name, "Render rate") == 0) {
+            mRenderRate = qBound(RENDER_MIN_RATE, atoi(value), RENDER_MAX_RATE);
+            emit updateRenderRate(mRenderRate);
+            consolePrintMessage(QString("render rate %1 Hz").arg(mRenderRate), 0);
+        } else if (strcmp(name, "Interpolation") == 0) {
+            mInterpolation = atoi(value);
+            emit updateInterpolation(mInterpolation);
+        } else if (strcmp(name, "Extrapolation") == 0) {
+            mExtrapolation = qBound(0, atoi(value), GAUGE_MAX_HORIZON);
+            emit updateExtrapolation(mExtrapolation);
+            consolePrintMessage(QString("rpm extrapolation %1 ms").arg(mExtrapolation), 0);
+        } else if (strcmp(name, "Overlay") == 0) {
+            settings->overlayCheck->setChecked(atoi(value));
+        } else if (strcmp(name, "Partial repaint") == 0) {
+            mPartialRepaint = atoi(value);
+            emit updatePartialRepaint(mPartialRepaint);
+            consolePrintMessage(QString("partial repaint %1").arg(mPartialRepaint ? "enabled" : "disabled"), 0);
+        } else if (strcmp(name, "Chart window") == 0) {
+            mChartWindow = qBound(CHART_MIN_WINDOW, atoi(value), CHART_MAX_WINDOW);
+            emit updateChartWindow(mChartWindow);
+            consolePrintMessage(QString("chart window %1 s").arg(mChartWindow), 0);
+        }
+    }
+}
+
+
+void Settings::readLimits(int key)
+{
+    LOG (LOG_SETTINGS, "%s - reading warning limits", CLASS_INFO);
+
+    int item = 0;
+    char *name, *value;
+
+    while (conf_list_items(key, &item, &name)) {
+        if (!conf_get_value(item, &value))
+            continue;
+
+        int channel = -1;
+        for (int i = 0; i < CHANNEL_COUNT; ++i) {
+            if (strcmp(name, channelNames[i]) == 0)
+                channel = i;
+        }
+
+        /* "warning alarm hysteresis" */
+        ThresholdLimits limits;
+        if (channel < 0 || sscanf(value, "%f %f %f", &limits.warning, &limits.alarm,
+                                  &limits.hysteresis) != 3) {
+            consolePrintMessage(QString("wrong limits \"%1\"").arg(name), 2);
+            continue;
+        }
+
+        mLimits[channel] = limits;
+        emit updateLimits(channel, limits.warning, limits.alarm, limits.hysteresis);
+    }
+}
+
+
+void Settings::readCaptureSettings(int key)
+{
+    LOG (LOG_SETTINGS, "%s - reading capture settings", CLASS_INFO);
+
+    Capture *capture = con->getCapture();
+    double pre = capture->getPreTrigger();
+    double post = capture->getPostTrigger();
+    bool triggersCleared = false;
+    int item = 0;
+    char *name, *value;
+
+    while (conf_list_items(key, &item, &name)) {
+        if (!conf_get_value(item, &value))
+            continue;
+
+        if (strcmp(name, "Enabled") == 0) {
+            capture->setEnabled(atoi(value));
+        } else if (strcmp(name, "Buffer frames") == 0) {
+            capture->setBufferSize(atoi(value));
+        } else if (strcmp(name, "Pre trigger") == 0) {
+            pre = atof(value);
+        } else if (strcmp(name, "Post trigger") == 0) {
+            post = atof(value);
+        } else if (strcmp(name, "Trigger") == 0) {
+            /* triggers from config replace the default one */
+            if (!triggersCleared) {
+                capture->clearTriggers();
+                triggersCleared = true;
+            }
+            capture->addTrigger(QString::fromUtf8(value));
+        }
+    }
+
+    capture->setWindow(pre, post);
+}
+
+
+void Settings::readComputedChannels(int key)
+{
+    LOG (LOG_SETTINGS, "%s - reading computed channels", CLASS_INFO);
+
+    int item = 0;
+    char *name, *value;
+
+    con->clearComputedChannels();
+
+    while (conf_list_items(key, &item, &name)) {
+        if (!conf_get_value(item, &value))
+            continue;
+        if (con->addComputedChannel(QString::fromUtf8(name), QString::fromUtf8(value)))
+            consolePrintMessage(QString("computed channel \"%1\" loaded").arg(name), 0);
+    }
 }
 
 
@@ -630,7 +778,7 @@ void Settings::saveConfigFile(void)
     LOG (LOG_SETTINGS, "%s - saving config file", CLASS_INFO);
 
     QFile file(FILE_NAME);
-    if (file.open(QIODevice::ReadWrite)) {
+    if (file.open(QIODevice::ReadWrite | QIODevice::Truncate)) {
         QTextStream out(&file);
 
         out << "# File generated automatically by VOCC. Do not make changes.\n";
@@ -645,6 +793,31 @@ void Settings::saveConfigFile(void)
             out << "|CAN mode| = |" << settings->convRadioBtn->text() << "|\n";
         out << "|Output console| = |" << settings->consoleCheck->isChecked() << "|\n";
         out << "|Output data| = |" << settings->canDataCheck->isChecked() << "|\n";
+        if (con->getComputedChannelCount() > 0) {
+            out << "|Computed channels|\n";
+            for (int i = 0; i < con->getComputedChannelCount(); ++i)
+                out << "\t|" << con->getComputedChannelName(i) << "| = |"
+                    << con->getComputedChannelSource(i) << "|\n";
+        }
+        Capture *capture = con->getCapture();
+        out << "|Capture|\n";
+        out << "\t|Enabled| = |" << capture->isEnabled() << "|\n";
+        out << "\t|Buffer frames| = |" << capture->getBufferSize() << "|\n";
+        out << "\t|Pre trigger| = |" << capture->getPreTrigger() << "|\n";
+        out << "\t|Post trigger| = |" << capture->getPostTrigger() << "|\n";
+        for (int i = 0; i < capture->getTriggers().size(); ++i)
+            out << "\t|Trigger| = |" << capture->getTriggers().at(i) << "|\n";
+        out << "|Display|\n";
+        out << "\t|Render rate| = |" << mRenderRate << "|\n";
+        out << "\t|Interpolation| = |" << mInterpolation << "|\n";
+        out << "\t|Extrapolation| = |" << mExtrapolation << "|\n";
+        out << "\t|Overlay| = |" << settings->overlayCheck->isChecked() << "|\n";
+        out << "\t|Partial repaint| = |" << mPartialRepaint << "|\n";
+        out << "\t|Chart window| = |" << mChartWindow << "|\n";
+        out << "|Limits|\n";
+        for (int i = 0; i < CHANNEL_COUNT; ++i)
+            out << "\t|" << channelNames[i] << "| = |" << mLimits[i].warning << " "
+                << mLimits[i].alarm << " " << mLimits[i].hysteresis << "|\n";
 
         file.close();
     } else {
@@ -689,8 +862,7 @@ void Settings::onContrastSliderValueChanged(int value)
 {
     LOG (LOG_SETTINGS, "%s - color changed %d", CLASS_INFO, value);
 
-    QString style = "background-color: rgb(%1, %2, %3);";
-    settings->gridFrame->setStyleSheet(style.arg(value).arg(value).arg(value));
+    /* palette propagates from main window theme */
     emit updateBackgroundContrast(value);
 }
 
@@ -710,10 +882,8 @@ void Settings::onFontSizeChanged(int index)
     LOG (LOG_SETTINGS, "%s - changing font to - %s", CLASS_INFO,
             settings->fontSizeBox->currentText().toStdString().c_str());
 
+    /* font propagates from main window theme */
     emit updateFontSize(settings->fontSizeBox->currentText());
-    QString size = settings->fontSizeBox->currentText();
-    QString style = "font: 75 bold %1pt";
-    settings->gridFrame->setStyleSheet(style.arg(size));
     consolePrintMessage("Font size changed", 0);
 
 }
@@ -25,6 +25,7 @@
 #include <QProgressBar>
 #include "progressIndicator.h"
 #include "../connections/connections.h"
+#include "../main/threshold.h"
 
 class QSslError;
 
@@ -106,6 +107,20 @@ signals:
     /// signal emitted to shutdown system
     void shutdownSystem();
     void rebootSystem();
+    /// signal emitted when render clock rate changed
+    void updateRenderRate(int);
+    /// signal emitted when rpm interpolation enabled/disabled
+    void updateInterpolation(bool);
+    /// signal emitted when rpm extrapolation horizon [ms] changed
+    void updateExtrapolation(int);
+    /// signal emitted when performance overlay enabled/disabled
+    void updateOverlay(bool);
+    /// signal emitted when partial repaint mode enabled/disabled
+    void updatePartialRepaint(bool);
+    /// signal emitted when visible time window of charts [s] changed
+    void updateChartWindow(int);
+    /// signal emitted when warning limits of channel changed (channel, warning, alarm, hysteresis)
+    void updateLimits(int, float, float, float);
 
 private:
     /// method which fills canbaud combobox with values
@@ -128,6 +143,14 @@ private:
     int stripBaudRateToInt(QString baud);
     /// saving file
     void saveConfigFile(void);
+    /// reads computed channels (children of given config key)
+    void readComputedChannels(int key);
+    /// reads capture window and triggers (children of given config key)
+    void readCaptureSettings(int key);
+    /// reads display settings (children of given config key)
+    void readDisplaySettings(int key);
+    /// reads warning limits of channels (children of given config key)
+    void readLimits(int key);
     /// set stylesheet
     template <typename T>
     void setWidgetStyleSheet(T &widget, const char* property, bool set);
@@ -139,6 +162,12 @@ private:
     QProgressIndicator *mPi;
     QLabel *mUpdateStatus;
     QString mVersion;
+    int mRenderRate; /// - render clock rate [Hz]
+    bool mInterpolation; /// - rpm interpolation at display rate
+    int mExtrapolation; /// - rpm extrapolation horizon [ms]
+    bool mPartialRepaint; /// - partial repaint mode of dashboard widgets
+    int mChartWindow; /// - visible time window of charts [s]
+    ThresholdLimits mLimits[CHANNEL_COUNT]; /// - warning limits of channels
     Connections *con;
     Ui::Settings *settings;
 };
@@ -0,0 +1,104 @@
+#include <QPainter>
+#include <QPaintEvent>
+#include <QFontMetrics>
+#include "distributionchart.h"
+#include "../common/logger.h"
+
+#define CLASS_INFO          "distribution chart"
+#define CHART_BACKGROUND    QColor(46, 48, 58)
+#define CHART_GRID          QColor(84, 86, 96)
+#define CHART_TEXT          QColor(190, 190, 196)
+#define CHART_BARS          QColor(74, 178, 143)
+#define CHART_MARGIN        6       /* [px] */
+
+
+DistributionChart::DistributionChart(QWidget *parent)
+    : QWidget(parent)
+{
+    LOG (LOG_STATS, "%s - in constructor", CLASS_INFO);
+
+    mDistribution = NULL;
+    mChannel = CHANNEL_RPM;
+    mScope = SCOPE_SESSION;
+
+    setMinimumSize(120, 80);
+    setAttribute(Qt::WA_OpaquePaintEvent);
+}
+
+
+DistributionChart::~DistributionChart()
+{
+
+}
+
+
+void DistributionChart::setChannel(const Distribution *distribution, int channel, int scope)
+{
+    mDistribution = distribution;
+    mChannel = qBound(0, channel, CHANNEL_COUNT - 1);
+    mScope = qBound(0, scope, SCOPE_COUNT - 1);
+    update();
+}
+
+
+void DistributionChart::refresh(void)
+{
+    update();
+}
+
+
+void DistributionChart::paintEvent(QPaintEvent *event)
+{
+    Q_UNUSED(event);
+
+    QPainter painter(this);
+    QFontMetrics metrics(font());
+    painter.fillRect(rect(), CHART_BACKGROUND);
+
+    if (!mDistribution)
+        return;
+
+    const DistributionHistogram &histogram = mDistribution->get(mChannel, mScope);
+    qint64 tallest = 0;
+    for (int i = 0; i < DISTRIBUTION_BINS; ++i)
+        tallest = qMax(tallest, histogram.bins[i]);
+
+    /* title with share of time of tallest bin, bars are scaled to it */
+    QString title = QString("Time at %1 [%2]").arg(channelNames[mChannel],
+                                                   mScope == SCOPE_LAP ? "lap" : "session");
+    if (histogram.time)
+        title += QString(" - max %1 %").arg(100.0 * tallest / histogram.time, 0, 'f', 1);
+
+    painter.setPen(CHART_TEXT);
+    painter.drawText(QRect(0, CHART_MARGIN, width(), metrics.height()), Qt::AlignCenter, title);
+
+    int top = CHART_MARGIN + metrics.height() + CHART_MARGIN;
+    QRect plot(CHART_MARGIN, top, width() - 2 * CHART_MARGIN,
+               height() - top - 2 * CHART_MARGIN - metrics.height());
+    if (plot.width() <= 0 || plot.height() <= 0)
+        return;
+
+    painter.setPen(CHART_GRID);
+    painter.drawLine(plot.bottomLeft(), plot.bottomRight());
+
+    /* range of channel under plot */
+    QRect labels(plot.left(), plot.bottom() + CHART_MARGIN, plot.width(), metrics.height());
+    painter.setPen(CHART_TEXT);
+    painter.drawText(labels, Qt::AlignLeft, QString::number(distributionRanges[mChannel][0], 'g', 4));
+    painter.drawText(labels, Qt::AlignHCenter,
+                     QString::number((distributionRanges[mChannel][0] + distributionRanges[mChannel][1]) / 2, 'g', 4));
+    painter.drawText(labels, Qt::AlignRight, QString::number(distributionRanges[mChannel][1], 'g', 4));
+
+    if (!tallest)
+        return;
+
+    for (int i = 0; i < DISTRIBUTION_BINS; ++i) {
+        if (!histogram.bins[i])
+            continue;
+
+        int left = plot.left() + plot.width() * i / DISTRIBUTION_BINS;
+        int right = plot.left() + plot.width() * (i + 1) / DISTRIBUTION_BINS;
+        int bar = qMax(1, int(plot.height() * histogram.bins[i] / tallest));
+        painter.fillRect(left, plot.bottom() - bar, qMax(1, right - left), bar, CHART_BARS);
+    }
+}
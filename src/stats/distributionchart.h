@@ -0,0 +1,50 @@
+/**
+ * \class DistributionChart
+ *
+ * \brief
+ *
+ * This class draws histogram of one telemetry channel (time at value, for
+ * example time at rpm) from bins of Distribution. Bars are scaled to the
+ * tallest bin, its share of time is printed above plot. Widget reads bins
+ * only when painted, refresh() is called by Statistics page timer.
+ *
+ * \version 1.0
+ *
+ * \date 2019/03/19 20:41:13
+ *
+ */
+#ifndef DISTRIBUTIONCHART_H
+#define DISTRIBUTIONCHART_H
+
+#include <QWidget>
+#include "../connections/distribution.h"
+
+class DistributionChart : public QWidget
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief DistributionChart - constructs chart without channel
+     * @param parent - QWidget parent
+     */
+    explicit DistributionChart(QWidget *parent = 0);
+    ~DistributionChart();
+
+    /// sets shown channel and scope of distribution
+    void setChannel(const Distribution *distribution, int channel, int scope);
+    /// repaints bars from current bins
+    void refresh(void);
+
+protected:
+    /**
+     * @brief paintEvent - reimplemented method, draws title, bars and range labels
+     */
+    void paintEvent(QPaintEvent *event);
+
+private:
+    const Distribution *mDistribution; /// - source of bins, NULL if none
+    int mChannel, mScope; /// - shown channel and scope
+};
+
+#endif // DISTRIBUTIONCHART_H
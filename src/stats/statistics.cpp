@@ -1,7 +1,14 @@
 #include "statistics.h"
 #include "ui_statistics.h"
 #include "../common/logger.h"
+#include "../main/overload.h"
 #include <QTableWidgetItem>
+#include <QShowEvent>
+#include <QHideEvent>
+#include <QHBoxLayout>
+#include <QVBoxLayout>
+#include <QHeaderView>
+#include <QStringList>
 #include <QStyle>
 #include <QString>
 
@@ -12,8 +19,22 @@
 #define MAX_VOLTAGE         110
 #define MAX_TEMP            100
 #define MAX_RPM             6000
-
-Statistics::Statistics(QWidget *parent, Connections *connection) :
+#define ZOOM_REFRESH_MS     1000
+#define ZOOM_SESSION        -1
+#define DISTRIBUTION_REFRESH_MS 500
+
+/* visible window of zoom levels [s] (0 - live trace) */
+static const int zoomSpans[] = { 0, 10, 60, 600, 3600, ZOOM_SESSION };
+static const char * const zoomNames[] = { "live", "10 s", "1 min", "10 min", "1 h", "session" };
+#define ZOOM_LEVELS         int(sizeof(zoomSpans) / sizeof(zoomSpans[0]))
+
+/* columns of distributions table, percentiles follow mean and max */
+static const char * const distributionColumns[] = { "time [s]", "min", "mean", "max", "p50", "p95", "p99", "beyond limit" };
+static const qreal distributionPercentiles[] = { 50, 95, 99 };
+#define DISTRIBUTION_COLUMNS    int(sizeof(distributionColumns) / sizeof(distributionColumns[0]))
+#define DISTRIBUTION_PERCENTILES int(sizeof(distributionPercentiles) / sizeof(distributionPercentiles[0]))
+
+Statistics::Statistics(QWidget *parent, Connections *connection, RenderScheduler *scheduler) :
     QWidget(parent),
     ui(new Ui::Statistics)
 {
@@ -21,30 +42,28 @@ Statistics::Statistics(QWidget *parent, Connections *connection) :
 
     ui->setupUi(this);
     con = connection;
+    render = scheduler;
 
     lastUpperButtonObject = NULL;
     lastBottomButtonObject = NULL;
+    upperInput = bottomInput = -1;
 
     initializeButtonSignals();
 
-    chartUpper = new Chart;
-    chartUpper->legend()->hide();
-    chartUpper->setAnimationOptions(QChart::AllAnimations);
-    viewUpper = new QChartView(chartUpper, ui->currentChartWidget);
-    viewUpper->setRenderHint(QPainter::Antialiasing, true);
-    ui->layoutCurrentChart->addWidget(viewUpper);
-    chartUpper->setTheme(QChart::ChartThemeDark);
+    connect (con, &Connections::computedChannelsChanged,
+                this, &Statistics::updateComputedChannelButtons);
+
+    chartUpper = new StripChart(ui->currentChartWidget);
+    ui->layoutCurrentChart->addWidget(chartUpper);
     chartUpper->setPenWidth(4);
 
-    chartBottom = new Chart;
-    chartBottom->legend()->hide();
-    chartBottom->setAnimationOptions(QChart::AllAnimations);
-    viewBottom = new QChartView(chartBottom, ui->powerChartWidget);
-    viewBottom->setRenderHint(QPainter::Antialiasing, true);
-    ui->layoutPowerChart->addWidget(viewBottom);
-    chartBottom->setTheme(QChart::ChartThemeDark);
+    chartBottom = new StripChart(ui->powerChartWidget);
+    ui->layoutPowerChart->addWidget(chartBottom);
     chartBottom->setPenWidth(4);
 
+    initializeZoom();
+    initializeDistribution();
+
 }
 
 void Statistics::initializeButtonSignals(void)
@@ -84,11 +103,285 @@ void Statistics::initializeButtonSignals(void)
 
 }
 
+void Statistics::initializeZoom(void)
+{
+    LOG (LOG_STATS, "%s - initializing zoom", CLASS_INFO);
+
+    zoom = 0;
+    panOffset = 0;
+
+    zoomOutButton = new QPushButton("-");
+    zoomInButton = new QPushButton("+");
+    zoomLabel = new QLabel;
+    zoomLabel->setAlignment(Qt::AlignCenter);
+    zoomLabel->setStyleSheet("color: white;");
+
+    QHBoxLayout *layout = new QHBoxLayout;
+    QPushButton *buttons[] = { zoomOutButton, zoomInButton };
+    for (int i = 0; i < 2; ++i) {
+        buttons[i]->setSizePolicy(ui->throttleChartBtn->sizePolicy());
+        buttons[i]->setMinimumSize(ui->throttleChartBtn->minimumSize());
+        buttons[i]->setStyleSheet(ui->throttleChartBtn->styleSheet());
+    }
+    layout->addWidget(zoomOutButton);
+    layout->addWidget(zoomLabel);
+    layout->addWidget(zoomInButton);
+    ui->verticalLayout_4->addLayout(layout);
+
+    connect (zoomOutButton, &QPushButton::clicked, this, [=] { setZoom(zoom + 1); });
+    connect (zoomInButton, &QPushButton::clicked, this, [=] { setZoom(zoom - 1); });
+    connect (chartUpper, &StripChart::zoomRequested, this, [=] (int steps) { setZoom(zoom - steps); });
+    connect (chartBottom, &StripChart::zoomRequested, this, [=] (int steps) { setZoom(zoom - steps); });
+    connect (chartUpper, &StripChart::panRequested, this, &Statistics::pan);
+    connect (chartBottom, &StripChart::panRequested, this, &Statistics::pan);
+    connect (&zoomTimer, &QTimer::timeout, this, &Statistics::refreshCharts);
+
+    setZoom(0);
+}
+
+void Statistics::initializeDistribution(void)
+{
+    LOG (LOG_STATS, "%s - initializing distributions", CLASS_INFO);
+
+    scope = SCOPE_SESSION;
+
+    distributionTable = new QTableWidget(CHANNEL_COUNT, DISTRIBUTION_COLUMNS);
+    distributionTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    distributionTable->setSelectionBehavior(QAbstractItemView::SelectRows);
+    distributionTable->setSelectionMode(QAbstractItemView::SingleSelection);
+    distributionTable->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    distributionTable->setStyleSheet("color: white; background-color: rgb(46, 48, 58);");
+    for (int i = 0; i < DISTRIBUTION_COLUMNS; ++i)
+        distributionTable->setHorizontalHeaderItem(i, new QTableWidgetItem(distributionColumns[i]));
+    for (int i = 0; i < CHANNEL_COUNT; ++i) {
+        distributionTable->setVerticalHeaderItem(i, new QTableWidgetItem(channelNames[i]));
+        for (int j = 0; j < DISTRIBUTION_COLUMNS; ++j) {
+            QTableWidgetItem *item = new QTableWidgetItem("-");
+            item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+            distributionTable->setItem(i, j, item);
+        }
+    }
+
+    distributionChart = new DistributionChart;
+    distributionChart->setChannel(con->getDistribution(), CHANNEL_RPM, scope);
+
+    QVBoxLayout *page = new QVBoxLayout(ui->oldDataPage);
+    page->addWidget(distributionTable);
+    page->addWidget(distributionChart);
+
+    viewButton = new QPushButton("Distributions");
+    scopeButton = new QPushButton("Session");
+    resetButton = new QPushButton("Reset");
+    scopeButton->setEnabled(false);
+    resetButton->setEnabled(false);
+
+    QHBoxLayout *layout = new QHBoxLayout;
+    QPushButton *buttons[] = { viewButton, scopeButton, resetButton };
+    for (int i = 0; i < 3; ++i) {
+        buttons[i]->setSizePolicy(ui->throttleChartBtn->sizePolicy());
+        buttons[i]->setMinimumSize(ui->throttleChartBtn->minimumSize());
+        buttons[i]->setStyleSheet(ui->throttleChartBtn->styleSheet());
+        layout->addWidget(buttons[i]);
+    }
+    /* view buttons are first, zoom buttons stay last */
+    ui->verticalLayout_4->insertLayout(0, layout);
+
+    connect (viewButton, &QPushButton::clicked, this, &Statistics::toggleView);
+    connect (scopeButton, &QPushButton::clicked, this, &Statistics::toggleScope);
+    connect (resetButton, &QPushButton::clicked, this, &Statistics::resetDistribution);
+    connect (distributionTable, &QTableWidget::currentCellChanged, this,
+                [=] (int row) { distributionChart->setChannel(con->getDistribution(), row, scope); });
+    connect (&distributionTimer, &QTimer::timeout, this, &Statistics::refreshDistribution);
+}
+
+bool Statistics::isDistributionShown(void) const
+{
+    return ui->chartsStackedWidget->currentWidget() == ui->oldDataPage;
+}
+
+void Statistics::toggleView(void)
+{
+    bool distribution = !isDistributionShown();
+
+    LOG (LOG_STATS, "%s - %s view", CLASS_INFO, distribution ? "distributions" : "charts");
+
+    ui->chartsStackedWidget->setCurrentWidget(distribution ? ui->oldDataPage : ui->currentDataPage);
+    viewButton->setText(distribution ? "Charts" : "Distributions");
+    scopeButton->setEnabled(distribution);
+    resetButton->setEnabled(distribution);
+
+    /* distributions are read only while they are shown */
+    if (distribution && isVisible()) {
+        refreshDistribution();
+        distributionTimer.start(DISTRIBUTION_REFRESH_MS);
+    } else {
+        distributionTimer.stop();
+    }
+}
+
+void Statistics::toggleScope(void)
+{
+    scope = (scope == SCOPE_LAP) ? SCOPE_SESSION : SCOPE_LAP;
+
+    LOG (LOG_STATS, "%s - %s distributions", CLASS_INFO, scope == SCOPE_LAP ? "lap" : "session");
+
+    scopeButton->setText(scope == SCOPE_LAP ? "Lap" : "Session");
+    distributionChart->setChannel(con->getDistribution(), qMax(0, distributionTable->currentRow()), scope);
+    refreshDistribution();
+}
+
+void Statistics::resetDistribution(void)
+{
+    con->getDistribution()->reset(scope);
+    refreshDistribution();
+}
+
+void Statistics::refreshDistribution(void)
+{
+    const Distribution *distribution = con->getDistribution();
+
+    for (int i = 0; i < CHANNEL_COUNT; ++i) {
+        const DistributionHistogram &histogram = distribution->get(i, scope);
+        int precision = (i == CHANNEL_RPM) ? 0 : 1;
+        QStringList cells;
+
+        if (!histogram.count && !histogram.time) {
+            for (int j = 0; j < DISTRIBUTION_COLUMNS; ++j)
+                cells << "-";
+        } else {
+            cells << QString::number(histogram.time / 1e6, 'f', 1)
+                  << QString::number(histogram.min, 'f', precision)
+                  << QString::number(distribution->getMean(i, scope), 'f', precision)
+                  << QString::number(histogram.max, 'f', precision);
+            for (int j = 0; j < DISTRIBUTION_PERCENTILES; ++j)
+                cells << QString::number(distribution->getPercentile(i, scope, distributionPercentiles[j]), 'f', precision);
+            if (distribution->hasLimit(i))
+                cells << QString("%1 s (%2 %)").arg(histogram.beyond / 1e6, 0, 'f', 1)
+                                                .arg(histogram.time ? 100.0 * histogram.beyond / histogram.time : 0, 0, 'f', 0);
+            else
+                cells << "-";
+        }
+
+        /* unchanged cells are not repainted */
+        for (int j = 0; j < DISTRIBUTION_COLUMNS; ++j) {
+            QTableWidgetItem *item = distributionTable->item(i, j);
+            if (item->text() != cells.at(j))
+                item->setText(cells.at(j));
+        }
+    }
+
+    distributionChart->refresh();
+}
+
+void Statistics::setZoom(int level)
+{
+    level = qBound(0, level, ZOOM_LEVELS - 1);
+    if (level != zoom)
+        LOG (LOG_STATS, "%s - zoom %s", CLASS_INFO, zoomNames[level]);
+
+    zoom = level;
+    if (!zoom)
+        panOffset = 0;
+
+    zoomLabel->setText(zoomNames[zoom]);
+    zoomInButton->setEnabled(zoom > 0);
+    zoomOutButton->setEnabled(zoom < ZOOM_LEVELS - 1);
+
+    /* zoomed history is not scrolled by render clock */
+    if (zoom && isVisible())
+        zoomTimer.start(ZOOM_REFRESH_MS);
+    else
+        zoomTimer.stop();
+
+    refreshCharts();
+}
+
+void Statistics::pan(qreal fraction)
+{
+    if (!zoom || zoomSpans[zoom] == ZOOM_SESSION)
+        return;
+
+    panOffset = qMax(qint64(0), panOffset + qint64(fraction * zoomSpans[zoom] * 1000000));
+    refreshCharts();
+}
+
+void Statistics::refreshCharts(void)
+{
+    showChart(chartUpper, upperInput);
+    showChart(chartBottom, bottomInput);
+}
+
+void Statistics::showChart(StripChart *chart, int input)
+{
+    if (input < 0)
+        return;
+
+    if (!zoom) {
+        if (chart->isZoomed())
+            chart->setZoom(QVector<HistoryBucket>());
+        fillChart(chart, input);
+        return;
+    }
+
+    /* pyramid of history answers any window in time proportional to plot width */
+    const History *history = con->getHistory();
+    qint64 latest = render->isActive() ? con->getCapture()->now() : history->getLatest(input);
+    qint64 end = latest - panOffset;
+    qint64 from = (zoomSpans[zoom] == ZOOM_SESSION) ? history->getOldest(input) :
+                                                      end - zoomSpans[zoom] * 1000000LL;
+
+    QVector<HistoryBucket> columns = history->query(input, from, end, chart->getColumns());
+
+    /* signal without samples keeps zoom with empty columns, not live trace under zoom label */
+    if (columns.isEmpty()) {
+        HistoryBucket empty = { 0, 0, 0, 0, 0 };
+        columns.fill(empty, chart->getColumns());
+    }
+
+    chart->setZoom(columns);
+}
+
+void Statistics::updateComputedChannelButtons(void)
+{
+    LOG (LOG_STATS, "%s - updating computed channels buttons", CLASS_INFO);
+
+    /* remove buttons of old channels */
+    for (int i = 0; i < computedButtons.size(); ++i) {
+        if (lastUpperButtonObject == computedButtons.at(i)) {
+            render->removeTargets(chartUpper);
+            lastUpperButtonObject = NULL;
+            upperInput = -1;
+        }
+        delete computedButtons.at(i);
+    }
+    computedButtons.clear();
+
+    for (int i = 0; i < con->getComputedChannelCount(); ++i) {
+        QPushButton *button = new QPushButton(con->getComputedChannelName(i));
+
+        button->setObjectName(QString("computedChartBtn%1").arg(i));
+        button->setProperty("computedChannel", i);
+        button->setSizePolicy(ui->throttleChartBtn->sizePolicy());
+        button->setMinimumSize(ui->throttleChartBtn->minimumSize());
+        button->setStyleSheet(ui->throttleChartBtn->styleSheet());
+        /* zoom buttons stay last */
+        ui->verticalLayout_4->insertWidget(ui->verticalLayout_4->count() - 1, button);
+
+        connect (button, &QPushButton::clicked, this,
+                    [=] { chartButtonChanged(*button); });
+        connect (button, &QPushButton::clicked, this,
+                    [=] { switchUpperChartData(*button); });
+
+        computedButtons.append(button);
+    }
+}
+
 void Statistics::chartButtonChanged(QPushButton &button)
 {
     if ( !QString::compare(button.objectName(), "currentChartBtn") ||
          !QString::compare(button.objectName(), "powerChartBtn") ||
-         !QString::compare(button.objectName(), "throttleChartBtn")) {
+         !QString::compare(button.objectName(), "throttleChartBtn") ||
+         button.property("computedChannel").isValid()) {
         if (lastUpperButtonObject == NULL) {
             lastUpperButtonObject = &button;
             styleUpdate(&button, true);
@@ -120,32 +413,38 @@ void Statistics::switchUpperChartData(QPushButton &button)
          button.objectName().toStdString().c_str());
 
 
-    if (QObject::disconnect(con, 0, chartUpper, 0))
-        LOG (LOG_STATS, "%s - disconnected upper chart data", CLASS_INFO);
+    render->removeTargets(chartUpper);
+    chartUpper->setAutoRange(false);
 
-    if (!QString::compare(button.objectName(), "currentChartBtn")) {
+    if (button.property("computedChannel").isValid()) {
+        int channel = button.property("computedChannel").toInt();
+
+        LOG (LOG_STATS, "%s - switched upper chart data to computed channel %d", CLASS_INFO, channel);
+        chartUpper->setTitle(QString("Computed: %1").arg(con->getComputedChannelName(channel)));
+        chartUpper->setAxisYRange(0, 1);
+        chartUpper->setAutoRange(true);
+        upperInput = RENDER_COMPUTED + channel;
+    } else if (!QString::compare(button.objectName(), "currentChartBtn")) {
         LOG (LOG_STATS, "%s - switched upper chart data to current [A]", CLASS_INFO);
         chartUpper->setTitle("Dynamic Battery Current Data [A]");
         chartUpper->setAxisYRange(0, MAX_CURRENT);
-
-        connect (con, &Connections::updateBatteryCurrent, chartUpper,
-                 [=] (quint16 value) { chartUpper->updateChart(value); });
+        upperInput = CHANNEL_CURRENT;
     } else if (!QString::compare(button.objectName(), "powerChartBtn")) {
         LOG (LOG_STATS, "%s - switched upper chart data to power [kW]", CLASS_INFO);
         chartUpper->setTitle("Dynamic Battery Power Data [kW]");
         chartUpper->setAxisYRange(0, MAX_POWER);
-
-        connect (con, &Connections::updatePower, chartUpper,
-                 [=] (quint16 value) { chartUpper->updateChart(value); });
+        upperInput = CHANNEL_POWER;
     } else {
         LOG (LOG_STATS, "%s - switched upper chart data to throttle [%]", CLASS_INFO);
         chartUpper->setTitle("Dynamic Throttle Data [%]");
         chartUpper->setAxisYRange(0, MAX_THROTTLE);
-
-        connect (con, &Connections::updateThrottle, chartUpper,
-                 [=] (quint16 value) { chartUpper->updateChart(value); });
+        upperInput = CHANNEL_THROTTLE;
     }
 
+    /* recent window of new signal is shown at once */
+    showChart(chartUpper, upperInput);
+    render->addTarget(chartUpper, upperInput,
+             [=] (float) { feedChart(chartUpper, upperInput); }, true, PAGE_STATS);
 }
 
 void Statistics::switchBottomChartData(QPushButton &button)
@@ -153,66 +452,111 @@ void Statistics::switchBottomChartData(QPushButton &button)
     LOG (LOG_STATS, "%s - switched bottom chart data to %s", CLASS_INFO,
          button.objectName().toStdString().c_str());
 
-    if (QObject::disconnect(con, 0, chartBottom, 0))
-        LOG (LOG_STATS, "%s - disconnected upper chart data", CLASS_INFO);
+    render->removeTargets(chartBottom);
 
     if (!QString::compare(button.objectName(), "voltageChartBtn")) {
         LOG (LOG_STATS, "%s - switched bottom chart data to voltage [V]", CLASS_INFO);
         chartBottom->setTitle("Dynamic Battery Voltage Data [V]");
         chartBottom->setAxisYRange(0, MAX_VOLTAGE);
-
-        connect (con, &Connections::updateBatteryVoltage, chartBottom,
-                 [=] (quint16 value) { chartBottom->updateChart(value); });
+        bottomInput = CHANNEL_VOLTAGE;
     } else if (!QString::compare(button.objectName(), "tempChartBtn")) {
         LOG (LOG_STATS, "%s - switched bottom chart data to controller temp [C]", CLASS_INFO);
         chartBottom->setTitle("Dynamic Controller Temperatures Data [C]");
         chartBottom->setAxisYRange(0, MAX_TEMP);
-
-        connect (con, &Connections::updateControllerTemp, chartBottom,
-                 [=] (quint16 value) { chartBottom->updateChart(value); });
+        bottomInput = CHANNEL_CONTR_TEMP;
     } else {
         LOG (LOG_STATS, "%s - switched upper chart data to motor speed [rpm]", CLASS_INFO);
         chartBottom->setTitle("Dynamic Motor Speed Data [rpm]");
         chartBottom->setAxisYRange(0, MAX_RPM);
+        bottomInput = CHANNEL_RPM;
+    }
+
+    showChart(chartBottom, bottomInput);
+    render->addTarget(chartBottom, bottomInput,
+             [=] (float) { feedChart(chartBottom, bottomInput); }, true, PAGE_STATS);
+}
 
-        connect (con, &Connections::updateRpmSpeed, chartBottom,
-                 [=] (quint16 value) { chartBottom->updateChart(value); });
+void Statistics::fillChart(StripChart *chart, int input)
+{
+    const History *history = con->getHistory();
+    qint64 end = render->isActive() ? con->getCapture()->now() : history->getLatest(input);
+
+    if (end < 0) {
+        chart->clear();
+        return;
     }
+
+    chart->fill(history->since(input, end - chart->getWindow() * 1000LL), end / 1000);
 }
 
-void Statistics::styleUpdate(QPushButton *button, bool isChanged)
+void Statistics::feedChart(StripChart *chart, int input)
 {
+    /* samples come with their decode times, render value is only a trigger */
+    QVector<HistorySample> samples = con->getHistory()->since(input, chart->getLatest() * 1000);
+    for (int i = 0; i < samples.size(); ++i)
+        chart->updateChart(samples.at(i).value, samples.at(i).time);
 
-    LOG (LOG_STATS, "%s - %s - %s", CLASS_INFO, Q_FUNC_INFO, \
-         button->objectName().toStdString().c_str());
+    /* called by render clock only while data is flowing (fed lines included) */
+    chart->advance(con->getCapture()->now() / 1000);
+}
 
-    button->setProperty("chosen", isChanged);
-    button->style()->unpolish(button);
-    button->style()->polish(button);
-    button->update();
+void Statistics::showEvent(QShowEvent *event)
+{
+    /* values decoded while page was hidden are in history */
+    refreshCharts();
+    if (zoom)
+        zoomTimer.start(ZOOM_REFRESH_MS);
+    if (isDistributionShown()) {
+        refreshDistribution();
+        distributionTimer.start(DISTRIBUTION_REFRESH_MS);
+    }
 
+    QWidget::showEvent(event);
 }
 
-void Statistics::enableChartData(void)
+void Statistics::hideEvent(QHideEvent *event)
 {
-    LOG (LOG_STATS, "%s - connected chart data", CLASS_INFO);
+    zoomTimer.stop();
+    distributionTimer.stop();
 
-    if (lastBottomButtonObject != NULL && lastUpperButtonObject != NULL)
-    {
-        switchUpperChartData(*lastUpperButtonObject);
-        switchBottomChartData(*lastBottomButtonObject);
-    }
+    QWidget::hideEvent(event);
+}
+
+void Statistics::setLoadLevel(int level)
+{
+    LOG (LOG_STATS, "%s - load level %d", CLASS_INFO, level);
 
+    int factor = (level >= LOAD_CHART_RATE) ? OVERLOAD_CHART_FACTOR : 1;
+    bool antialiasing = (level < LOAD_CHART_ANTIALIASING);
+
+    chartUpper->setLoadFactor(factor);
+    chartBottom->setLoadFactor(factor);
+    chartUpper->setAntialiasing(antialiasing);
+    chartBottom->setAntialiasing(antialiasing);
+
+    /* charts are cleared when bucket duration changes, window is filled again */
+    refreshCharts();
 }
 
-void Statistics::disableChartData(void)
+void Statistics::setChartWindow(int seconds)
+{
+    LOG (LOG_STATS, "%s - chart window %d s", CLASS_INFO, seconds);
+
+    chartUpper->setWindow(seconds * 1000);
+    chartBottom->setWindow(seconds * 1000);
+    refreshCharts();
+}
+
+void Statistics::styleUpdate(QPushButton *button, bool isChanged)
 {
-    LOG (LOG_STATS, "%s - disconnected chart data", CLASS_INFO);
 
-    if (QObject::disconnect(con, 0, chartUpper, 0))
-        LOG (LOG_STATS, "%s - disconnected upper chart data", CLASS_INFO);
-    if (QObject::disconnect(con, 0, chartBottom, 0))
-        LOG (LOG_STATS, "%s - disconnected bottom chart data", CLASS_INFO);
+    LOG (LOG_STATS, "%s - %s - %s", CLASS_INFO, Q_FUNC_INFO, \
+         button->objectName().toStdString().c_str());
+
+    button->setProperty("chosen", isChanged);
+    button->style()->unpolish(button);
+    button->style()->polish(button);
+    button->update();
 
 }
 
@@ -20,8 +20,13 @@
 
 #include <QWidget>
 #include <QPushButton>
-#include "chart.h"
+#include <QLabel>
+#include <QTimer>
+#include <QTableWidget>
+#include "stripchart.h"
+#include "distributionchart.h"
 #include "../connections/connections.h"
+#include "../main/renderscheduler.h"
 
 namespace Ui {
 class Statistics;
@@ -36,26 +41,77 @@ public:
      * @brief Statistics - costructs Statistics widget
      * @param parent
      */
-    explicit Statistics(QWidget *parent, Connections *connection);
+    explicit Statistics(QWidget *parent, Connections *connection, RenderScheduler *scheduler);
     ~Statistics();
 
 public slots:
-    void enableChartData(void);
-    void disableChartData(void);
+    /// sheds or restores charts refresh rate and animations (LoadLevel)
+    void setLoadLevel(int level);
+    /// sets visible time window of live charts [s]
+    void setChartWindow(int seconds);
+
+protected:
+    /**
+     * @brief showEvent - reimplemented method, fills charts with values decoded while page was hidden
+     */
+    void showEvent(QShowEvent *event);
+    /**
+     * @brief hideEvent - reimplemented method, stops refreshing of zoomed charts and distributions
+     */
+    void hideEvent(QHideEvent *event);
 
 private slots:
     void chartButtonChanged(QPushButton &button);
     void switchUpperChartData(QPushButton &button);
     void switchBottomChartData(QPushButton &button);
+    void updateComputedChannelButtons(void);
+    /// sets zoom level of both charts (0 - live)
+    void setZoom(int level);
+    /// moves zoomed window by part of it (positive to older data)
+    void pan(qreal fraction);
+    /// shows live window or zoomed history in both charts
+    void refreshCharts(void);
+    /// switches between charts and distributions view
+    void toggleView(void);
+    /// switches shown distributions between lap and session
+    void toggleScope(void);
+    /// clears shown distributions scope
+    void resetDistribution(void);
+    /// fills distributions table and histogram with current values
+    void refreshDistribution(void);
 
 private:
-    Chart *chartUpper, *chartBottom;
-    QChartView *viewUpper, *viewBottom;
+    StripChart *chartUpper, *chartBottom;
     Ui::Statistics *ui;
     Connections *con;
+    RenderScheduler *render;
     QPushButton *lastUpperButtonObject, *lastBottomButtonObject;
+    QList<QPushButton *> computedButtons;
+    int upperInput, bottomInput; /// - render inputs of charts, -1 if none
+    int zoom; /// - zoom level of charts (index of zoomSpans)
+    qint64 panOffset; /// - end of zoomed window before now [us]
+    QTimer zoomTimer; /// - refreshes zoomed charts
+    QPushButton *zoomInButton, *zoomOutButton;
+    QLabel *zoomLabel; /// - shows zoomed window
+    QTableWidget *distributionTable; /// - min/mean/max, percentiles and time beyond limit of channels
+    DistributionChart *distributionChart; /// - histogram of channel selected in table
+    QTimer distributionTimer; /// - refreshes distributions view
+    QPushButton *viewButton, *scopeButton, *resetButton;
+    int scope; /// - shown distributions scope (DistributionScope)
 
     void initializeButtonSignals(void);
+    /// creates zoom buttons and connects zoom and pan requests of charts
+    void initializeZoom(void);
+    /// creates distributions view (page of charts stacked widget) and its buttons
+    void initializeDistribution(void);
+    /// returns true if distributions view is shown
+    bool isDistributionShown(void) const;
+    /// shows live window or zoomed history of input in chart
+    void showChart(StripChart *chart, int input);
+    /// replaces points of chart by recent window of input from history
+    void fillChart(StripChart *chart, int input);
+    /// adds samples of input decoded since last frame to chart, moves its window to now (render clock)
+    void feedChart(StripChart *chart, int input);
     void styleUpdate(QPushButton *button, bool isChanged);
 };
 
@@ -0,0 +1,583 @@
+#include <QPainter>
+#include <QPaintEvent>
+#include <QGestureEvent>
+#include <QPinchGesture>
+#include <QWheelEvent>
+#include <QMouseEvent>
+#include <QFontMetrics>
+#include <QStringList>
+#include <QtMath>
+#include "stripchart.h"
+#include "../common/logger.h"
+
+#define CLASS_INFO          "strip chart"
+#define CHART_BACKGROUND    QColor(46, 48, 58)
+#define CHART_GRID          QColor(84, 86, 96)
+#define CHART_TEXT          QColor(190, 190, 196)
+#define CHART_TRACE         QColor(74, 178, 143)
+#define CHART_BAND_ALPHA    110     /* alpha of min/max band of zoomed chart */
+#define PINCH_STEP          1.5     /* scale of pinch which zooms one step */
+#define DRAG_THRESHOLD      10      /* [px] */
+
+
+StripChart::StripChart(QWidget *parent)
+    : QWidget(parent)
+{
+    LOG (LOG_STATS, "%s - in constructor", CLASS_INFO);
+
+    mMin = 0;
+    mMax = 10;
+    mPen = QPen(CHART_TRACE, 4, Qt::SolidLine, Qt::RoundCap, Qt::RoundJoin);
+    mAntialiasing = true;
+    mWindow = CHART_DEFAULT_WINDOW * 1000;
+    mLoadFactor = 1;
+    mDuration = mWindow / CHART_VISIBLE_POINTS;
+    mAutoRange = false;
+
+    mPressX = -1;
+
+    mRing.resize(CHART_CAPACITY);
+    clear();
+
+    setMinimumSize(120, 80);
+    setAttribute(Qt::WA_OpaquePaintEvent);
+    grabGesture(Qt::PinchGesture);
+}
+
+
+StripChart::~StripChart()
+{
+
+}
+
+
+void StripChart::setTitle(const QString &title)
+{
+    mTitle = title;
+    renderBackground();
+    update();
+}
+
+
+void StripChart::setAxisYRange(qreal min, qreal max)
+{
+    if (max <= min)
+        return;
+
+    mMin = min;
+    mMax = max;
+    renderBackground();
+    renderTrace();
+    update();
+}
+
+
+void StripChart::setPenColor(QColor color)
+{
+    mPen.setColor(color);
+    renderTrace();
+    update(mPlot);
+}
+
+
+void StripChart::setPenWidth(int width)
+{
+    if (width > 0) {
+        mPen.setWidth(width);
+        renderTrace();
+        update(mPlot);
+    }
+}
+
+
+void StripChart::setWindow(int window)
+{
+    window = qMax(CHART_VISIBLE_POINTS, window);
+    if (window == mWindow)
+        return;
+
+    LOG (LOG_STATS, "%s - window %d ms", CLASS_INFO, window);
+
+    mWindow = window;
+    mDuration = qint64(mWindow) * mLoadFactor / CHART_VISIBLE_POINTS;
+    clear();
+}
+
+
+int StripChart::getWindow(void) const
+{
+    return mWindow;
+}
+
+
+void StripChart::setAutoRange(bool enable)
+{
+    mAutoRange = enable;
+}
+
+
+void StripChart::setLoadFactor(int factor)
+{
+    factor = qMax(1, factor);
+    if (factor == mLoadFactor)
+        return;
+
+    /* longer buckets - fewer points and scrolls */
+    mLoadFactor = factor;
+    mDuration = qint64(mWindow) * mLoadFactor / CHART_VISIBLE_POINTS;
+    clear();
+}
+
+
+void StripChart::setAntialiasing(bool enable)
+{
+    if (enable == mAntialiasing)
+        return;
+
+    mAntialiasing = enable;
+    renderTrace();
+    update(mPlot);
+}
+
+
+void StripChart::clear(void)
+{
+    mBucket = -1;
+    mBucketMin = mBucketMax = 0;
+    mMinAt = mMaxAt = 0;
+    mLatest = -1;
+    mEdge = 0;
+    mPending = 0;
+    mHead = mPoints = 0;
+
+    renderTrace();
+    update(mPlot);
+}
+
+
+void StripChart::fill(const QVector<HistorySample> &samples, qint64 now)
+{
+    LOG (LOG_STATS, "%s - filling with %d samples", CLASS_INFO, samples.size());
+
+    mBucket = -1;
+    mLatest = -1;
+    mHead = mPoints = 0;
+
+    qreal min = mMin, max = mMax;
+    for (int i = 0; i < samples.size(); ++i) {
+        qreal value = samples.at(i).value;
+        if (mAutoRange && (value > max || value < min)) {
+            min = qMin(value * 1.1, min);
+            max = qMax(value * 1.1, max);
+        }
+        add(value, samples.at(i).time);
+    }
+
+    /* window ends at now, bucket passed by clock is complete */
+    mEdge = now - now % mDuration;
+    if (mBucket >= 0 && (mBucket + 1) * mDuration <= mEdge)
+        close();
+    mPending = 0;
+
+    if (min != mMin || max != mMax) {
+        setAxisYRange(min, max);
+    } else {
+        renderTrace();
+        update(mPlot);
+    }
+}
+
+
+qint64 StripChart::getLatest(void) const
+{
+    return mLatest;
+}
+
+
+void StripChart::setZoom(const QVector<HistoryBucket> &columns)
+{
+    mColumns = columns;
+
+    /* extend Y axis by extremes of columns (computed channels) */
+    qreal min = mMin, max = mMax;
+    for (int i = 0; mAutoRange && i < mColumns.size(); ++i) {
+        if (!mColumns.at(i).count)
+            continue;
+        if (mColumns.at(i).min < min)
+            min = mColumns.at(i).min * 1.1;
+        if (mColumns.at(i).max > max)
+            max = mColumns.at(i).max * 1.1;
+    }
+
+    if (min != mMin || max != mMax) {
+        setAxisYRange(min, max);
+    } else {
+        renderTrace();
+        update(mPlot);
+    }
+}
+
+
+bool StripChart::isZoomed(void) const
+{
+    return !mColumns.isEmpty();
+}
+
+
+int StripChart::getColumns(void) const
+{
+    return mPlot.width();
+}
+
+
+void StripChart::updateChart(qreal value, qint64 time)
+{
+    if (time < mLatest)
+        return;
+
+    /* extend Y axis if value is out of range (computed channels) */
+    if (mAutoRange && (value > mMax || value < mMin))
+        setAxisYRange(qMin(value * 1.1, mMin), qMax(value * 1.1, mMax));
+
+    mPending += add(value, time);
+}
+
+
+void StripChart::advance(qint64 now)
+{
+    qint64 edge = now - now % mDuration;
+    if (edge <= mEdge)
+        return;
+
+    /* bucket passed by clock is complete, no later sample can fall in it */
+    if (mBucket >= 0 && (mBucket + 1) * mDuration <= edge)
+        mPending += close();
+
+    int before = origin();
+    mEdge = edge;
+    if (!isZoomed()) {
+        scrollTrace(origin() - before, mPending);
+        update(mPlot);
+    }
+    mPending = 0;
+}
+
+
+int StripChart::add(qreal value, qint64 time)
+{
+    qint64 bucket = time / mDuration;
+    int points = 0;
+
+    /* sample of next bucket closes the open one */
+    if (mBucket >= 0 && bucket != mBucket)
+        points = close();
+
+    /* no data between samples further apart than gap (always in different buckets) */
+    if (mLatest >= 0 && time - mLatest > qMax(qint64(CHART_GAP), 2 * mDuration)) {
+        push(mLatest, qQNaN());
+        points++;
+    }
+    mLatest = time;
+
+    if (mBucket < 0) {
+        mBucket = bucket;
+        mBucketMin = mBucketMax = value;
+        mMinAt = mMaxAt = time;
+        return points;
+    }
+
+    if (value < mBucketMin) {
+        mBucketMin = value;
+        mMinAt = time;
+    }
+    if (value > mBucketMax) {
+        mBucketMax = value;
+        mMaxAt = time;
+    }
+
+    return points;
+}
+
+
+int StripChart::close(void)
+{
+    if (mBucket < 0)
+        return 0;
+
+    /* extremes at their times in time order */
+    int points = 1;
+    if (mMinAt == mMaxAt) {
+        push(mMinAt, mBucketMin);
+    } else if (mMinAt < mMaxAt) {
+        push(mMinAt, mBucketMin);
+        push(mMaxAt, mBucketMax);
+        points = 2;
+    } else {
+        push(mMaxAt, mBucketMax);
+        push(mMinAt, mBucketMin);
+        points = 2;
+    }
+    mBucket = -1;
+
+    return points;
+}
+
+
+void StripChart::push(qreal x, qreal y)
+{
+    mRing[mHead] = QPointF(x, y);
+    mHead = (mHead + 1) % CHART_CAPACITY;
+    mPoints = qMin(mPoints + 1, CHART_CAPACITY);
+}
+
+
+const QPointF &StripChart::point(int index) const
+{
+    return mRing.at((mHead - mPoints + index + CHART_CAPACITY) % CHART_CAPACITY);
+}
+
+
+int StripChart::origin(void) const
+{
+    return qRound(qreal(mEdge) * mPlot.width() / mWindow);
+}
+
+
+QPointF StripChart::map(const QPointF &point) const
+{
+    /* right edge of window is at right edge of plot, pen must not be cut by it */
+    qreal right = mTrace.width() - 1 - mPen.widthF() / 2;
+    qreal x = right + point.x() * mPlot.width() / mWindow - origin();
+    qreal y = (mMax - point.y()) / (mMax - mMin) * (mTrace.height() - 1);
+
+    return QPointF(x, y);
+}
+
+
+void StripChart::drawPoints(QPainter &painter, int first)
+{
+    QPolygonF polygon;
+    polygon.reserve(mPoints - first);
+
+    /* gap (NaN) ends polyline, lone point between gaps is drawn as a dot */
+    for (int i = first; i <= mPoints; ++i) {
+        if (i < mPoints && !qIsNaN(point(i).y())) {
+            polygon << map(point(i));
+            continue;
+        }
+
+        if (polygon.size() == 1)
+            painter.drawPoint(polygon.first());
+        else if (polygon.size() > 1)
+            painter.drawPolyline(polygon);
+        polygon.clear();
+    }
+}
+
+
+void StripChart::renderBackground(void)
+{
+    if (width() <= 0 || height() <= 0)
+        return;
+
+    QFontMetrics metrics(font());
+    QFont titleFont(font());
+    titleFont.setBold(true);
+    QFontMetrics titleMetrics(titleFont);
+
+    /* labels of grid lines */
+    QStringList labels;
+    int labelWidth = 0;
+    for (int i = 0; i <= CHART_GRID_LINES; ++i) {
+        labels << QString::number(mMax - (mMax - mMin) * i / CHART_GRID_LINES, 'g', 4);
+        labelWidth = qMax(labelWidth, metrics.width(labels.last()));
+    }
+
+    int top = CHART_MARGIN + (mTitle.isEmpty() ? 0 : titleMetrics.height() + CHART_MARGIN) + metrics.height() / 2;
+    int left = CHART_MARGIN + labelWidth + CHART_MARGIN;
+    mPlot = QRect(left, top, qMax(1, width() - left - CHART_MARGIN),
+                  qMax(1, height() - top - CHART_MARGIN - metrics.height() / 2));
+
+    mBackground = QPixmap(size());
+    mBackground.fill(CHART_BACKGROUND);
+
+    QPainter painter(&mBackground);
+    painter.setPen(CHART_TEXT);
+    if (!mTitle.isEmpty()) {
+        painter.setFont(titleFont);
+        painter.drawText(QRect(0, CHART_MARGIN, width(), titleMetrics.height()), Qt::AlignCenter, mTitle);
+        painter.setFont(font());
+    }
+
+    for (int i = 0; i <= CHART_GRID_LINES; ++i) {
+        int y = mPlot.top() + (mPlot.height() - 1) * i / CHART_GRID_LINES;
+
+        painter.setPen(CHART_GRID);
+        painter.drawLine(mPlot.left(), y, mPlot.right(), y);
+        painter.setPen(CHART_TEXT);
+        painter.drawText(QRect(CHART_MARGIN, y - metrics.height() / 2, labelWidth, metrics.height()),
+                         Qt::AlignRight | Qt::AlignVCenter, labels.at(i));
+    }
+    painter.end();
+
+    LOG (LOG_STATS, "%s - background %dx%d rendered", CLASS_INFO, width(), height());
+}
+
+
+void StripChart::renderTrace(void)
+{
+    if (mPlot.isEmpty())
+        return;
+
+    if (mTrace.size() != mPlot.size())
+        mTrace = QPixmap(mPlot.size());
+    mTrace.fill(Qt::transparent);
+
+    if (isZoomed()) {
+        QPainter painter(&mTrace);
+        renderColumns(painter);
+        return;
+    }
+
+    if (!mPoints)
+        return;
+
+    QPainter painter(&mTrace);
+    painter.setRenderHint(QPainter::Antialiasing, mAntialiasing);
+    painter.setPen(mPen);
+    drawPoints(painter, 0);
+}
+
+
+void StripChart::renderColumns(QPainter &painter)
+{
+    QColor band(mPen.color());
+    band.setAlpha(CHART_BAND_ALPHA);
+    qreal scale = (mTrace.height() - 1) / (mMax - mMin);
+    qreal step = qreal(mTrace.width()) / mColumns.size();
+    QPolygonF mean;
+
+    /* min/max band shows spikes, mean line is drawn over it */
+    painter.setPen(QPen(band, qMax(1.0, step)));
+    for (int i = 0; i < mColumns.size(); ++i) {
+        const HistoryBucket &column = mColumns.at(i);
+        if (!column.count)
+            continue;
+
+        qreal x = (i + 0.5) * step;
+        painter.drawLine(QPointF(x, (mMax - column.max) * scale), QPointF(x, (mMax - column.min) * scale));
+        mean << QPointF(x, (mMax - column.mean) * scale);
+    }
+
+    QPen pen(mPen);
+    pen.setWidthF(qMax(1.0, mPen.widthF() / 2));
+    painter.setRenderHint(QPainter::Antialiasing, mAntialiasing);
+    painter.setPen(pen);
+    painter.drawPolyline(mean);
+}
+
+
+void StripChart::scrollTrace(int shift, int points)
+{
+    int pad = qCeil(mPen.widthF()) + 1;
+
+    if (mTrace.isNull())
+        return;
+    if (shift + 2 * pad >= mTrace.width() || mPoints < 2) {
+        renderTrace();
+        return;
+    }
+
+    /* blit drawn trace, only exposed strip and end of previous segment are drawn */
+    mTrace.scroll(-shift, 0, mTrace.rect());
+    QRect strip(mTrace.width() - shift - 2 * pad, 0, shift + 2 * pad, mTrace.height());
+
+    QPainter painter(&mTrace);
+    painter.setCompositionMode(QPainter::CompositionMode_Source);
+    painter.fillRect(strip, Qt::transparent);
+    painter.setCompositionMode(QPainter::CompositionMode_SourceOver);
+    painter.setClipRect(strip);
+
+    /* new points and older points reaching into strip */
+    int first = mPoints - qMin(mPoints, points + 1);
+    while (first > 0 && map(point(first)).x() + pad >= strip.left())
+        first--;
+
+    painter.setRenderHint(QPainter::Antialiasing, mAntialiasing);
+    painter.setPen(mPen);
+    drawPoints(painter, first);
+}
+
+
+void StripChart::paintEvent(QPaintEvent *event)
+{
+    Q_UNUSED(event);
+
+    QPainter painter(this);
+    painter.drawPixmap(0, 0, mBackground);
+    painter.drawPixmap(mPlot.topLeft(), mTrace);
+}
+
+
+void StripChart::resizeEvent(QResizeEvent *event)
+{
+    renderBackground();
+    renderTrace();
+    QWidget::resizeEvent(event);
+}
+
+
+bool StripChart::event(QEvent *event)
+{
+    if (event->type() != QEvent::Gesture)
+        return QWidget::event(event);
+
+    QPinchGesture *pinch = static_cast<QPinchGesture *>(static_cast<QGestureEvent *>(event)->gesture(Qt::PinchGesture));
+    if (pinch && pinch->state() == Qt::GestureFinished) {
+        if (pinch->totalScaleFactor() >= PINCH_STEP)
+            emit zoomRequested(1);
+        else if (pinch->totalScaleFactor() <= 1 / PINCH_STEP)
+            emit zoomRequested(-1);
+    }
+
+    return true;
+}
+
+
+void StripChart::wheelEvent(QWheelEvent *event)
+{
+    if (event->angleDelta().y())
+        emit zoomRequested(event->angleDelta().y() > 0 ? 1 : -1);
+    event->accept();
+}
+
+
+void StripChart::mousePressEvent(QMouseEvent *event)
+{
+    mPressX = event->x();
+    QWidget::mousePressEvent(event);
+}
+
+
+void StripChart::mouseReleaseEvent(QMouseEvent *event)
+{
+    /* dragging right moves to older data */
+    int dx = event->x() - mPressX;
+    if (mPressX >= 0 && qAbs(dx) >= DRAG_THRESHOLD && mPlot.width() > 0)
+        emit panRequested(qreal(dx) / mPlot.width());
+
+    mPressX = -1;
+    QWidget::mouseReleaseEvent(event);
+}
+
+
+void StripChart::changeEvent(QEvent *event)
+{
+    if (event->type() == QEvent::FontChange) {
+        renderBackground();
+        renderTrace();
+        update();
+    }
+
+    QWidget::changeEvent(event);
+}
@@ -0,0 +1,190 @@
+/**
+ * \class StripChart
+ *
+ * \brief
+ *
+ * This class is a scrolling strip chart of one signal (replaces QtCharts).
+ * X axis is time: samples come with their decode times and the plot shows
+ * a configurable window ending at capture clock now. Samples are decimated
+ * to time buckets (window / CHART_VISIBLE_POINTS times load factor) aligned
+ * to capture clock, so charts of signals with different rates stay aligned.
+ * Minimum and maximum of a bucket are tracked as samples arrive and both are
+ * plotted at their times, so spikes stay visible. Samples further apart than
+ * CHART_GAP break the trace. Last CHART_CAPACITY points are kept in a fixed
+ * ring.
+ *
+ * Title, grid and Y axis labels are rendered once to a background pixmap
+ * (on resize, range or title change). Trace is kept in its own pixmap: when
+ * clock passes a bucket it is scrolled left by pixel blit and only the exposed
+ * strip is drawn, whole trace is redrawn from ring only when geometry or range
+ * changes.
+ *
+ * Chart can be filled at once with recent samples (History), it is rendered
+ * once after all of them are added.
+ *
+ * Zoomed chart shows columns of history (min/max band and mean line) given
+ * by setZoom() instead of live trace, live samples are still kept. Pinch and
+ * wheel request zoom, horizontal drag requests pan.
+ *
+ * \version 1.0
+ *
+ * \date 2019/03/14 18:36:05
+ *
+ */
+#ifndef STRIPCHART_H
+#define STRIPCHART_H
+
+#include <QWidget>
+#include <QPixmap>
+#include <QPointF>
+#include <QVector>
+#include <QColor>
+#include <QPen>
+#include <QString>
+#include "../connections/history.h"
+
+#define CHART_VISIBLE_POINTS    60      /* buckets across plot area */
+#define CHART_CAPACITY          (3 * (CHART_VISIBLE_POINTS + 2))  /* points kept, min/max and gap of visible and one off-screen bucket */
+#define CHART_GAP               500     /* [ms] samples further apart break trace */
+#define CHART_DEFAULT_WINDOW    10      /* [s] */
+#define CHART_MIN_WINDOW        2       /* [s] */
+#define CHART_MAX_WINDOW        120     /* [s] */
+#define CHART_GRID_LINES        5       /* horizontal grid divisions */
+#define CHART_MARGIN            6       /* [px] */
+
+class StripChart : public QWidget
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief StripChart - constructs empty chart with Y range 0 - 10
+     * @param parent - QWidget parent
+     */
+    explicit StripChart(QWidget *parent = 0);
+    ~StripChart();
+
+    /// sets title drawn above plot
+    void setTitle(const QString &title);
+    /// sets Y axis range, trace is redrawn
+    void setAxisYRange(qreal min, qreal max);
+    /// sets trace color/width
+    void setPenColor(QColor color);
+    void setPenWidth(int width);
+    /// sets visible time window [ms], chart is cleared
+    void setWindow(int window);
+    /// returns visible time window [ms]
+    int getWindow(void) const;
+    /// enables/disables extending of Y axis by out of range values (computed channels)
+    void setAutoRange(bool enable);
+    /// sets bucket duration multiplier (LoadLevel), chart is cleared when changed
+    void setLoadFactor(int factor);
+    /// enables/disables antialiasing of trace (LoadLevel)
+    void setAntialiasing(bool enable);
+    /// removes all points
+    void clear(void);
+    /// replaces points by samples (oldest first) and moves window to now [ms], trace is rendered once
+    void fill(const QVector<HistorySample> &samples, qint64 now);
+    /// returns time of newest added sample [ms], -1 if there is none
+    qint64 getLatest(void) const;
+    /// shows columns of history instead of live trace, empty columns return to live trace
+    void setZoom(const QVector<HistoryBucket> &columns);
+    /// returns true if columns of history are shown
+    bool isZoomed(void) const;
+    /// returns width of plot area [px]
+    int getColumns(void) const;
+
+signals:
+    /// signal emitted when zoom in (positive steps) or zoom out (negative steps) is requested
+    void zoomRequested(int);
+    /// signal emitted when pan is requested (part of window, positive to older data)
+    void panRequested(qreal);
+
+public slots:
+    /// adds sample decoded at time [ms], older samples than the newest one are ignored
+    void updateChart(qreal value, qint64 time);
+    /// moves window to now [ms], trace is scrolled when clock passed a bucket
+    void advance(qint64 now);
+
+protected:
+    /**
+     * @brief paintEvent - reimplemented method, draws background and trace pixmaps
+     */
+    void paintEvent(QPaintEvent *event);
+    /**
+     * @brief resizeEvent - reimplemented method, recreates background and trace
+     */
+    void resizeEvent(QResizeEvent *event);
+    /**
+     * @brief changeEvent - reimplemented method, recreates background when font changed
+     */
+    void changeEvent(QEvent *event);
+    /**
+     * @brief event - reimplemented method, handles pinch gesture
+     */
+    bool event(QEvent *event);
+    /**
+     * @brief wheelEvent - reimplemented method, requests zoom
+     */
+    void wheelEvent(QWheelEvent *event);
+    /**
+     * @brief mousePressEvent, mouseReleaseEvent - reimplemented methods, request pan by drag
+     */
+    void mousePressEvent(QMouseEvent *event);
+    void mouseReleaseEvent(QMouseEvent *event);
+
+private:
+    /// adds sample to bucket, returns number of points added when previous bucket is closed
+    int add(qreal value, qint64 time);
+    /// pushes extremes of open bucket to ring, returns number of points
+    int close(void);
+    /// adds point to ring, oldest point is overwritten when ring is full
+    void push(qreal x, qreal y);
+    /// returns point of ring in time order (0 - oldest)
+    const QPointF &point(int index) const;
+    /// maps point (time [ms], value) to trace pixmap
+    QPointF map(const QPointF &point) const;
+    /// draws points of ring from first on, trace is broken at gaps
+    void drawPoints(QPainter &painter, int first);
+    /// renders title, grid and labels, lays out plot area
+    void renderBackground(void);
+    /// renders whole trace from ring (columns when zoomed)
+    void renderTrace(void);
+    /// renders columns of history
+    void renderColumns(QPainter &painter);
+    /**
+     * @brief scrollTrace - scrolls trace left and draws its exposed strip
+     * @param shift - scroll [px]
+     * @param points - points added since last scroll
+     */
+    void scrollTrace(int shift, int points);
+    /// returns position of right edge of window in trace pixmap [px]
+    int origin(void) const;
+
+    QString mTitle; /// - title
+    qreal mMin, mMax; /// - Y axis range
+    QPen mPen; /// - trace pen
+    bool mAntialiasing; /// - trace antialiasing
+    int mWindow, mLoadFactor; /// - visible window [ms], bucket duration multiplier
+    qint64 mDuration; /// - bucket duration [ms]
+    bool mAutoRange; /// - Y axis follows out of range values
+
+    qint64 mBucket; /// - index of open bucket (time / mDuration), -1 if none
+    qreal mBucketMin, mBucketMax; /// - extremes of open bucket
+    qint64 mMinAt, mMaxAt; /// - time of extremes [ms]
+    qint64 mLatest; /// - time of newest sample [ms], -1 if none
+    qint64 mEdge; /// - right edge of window, end of newest closed bucket [ms]
+    int mPending; /// - points pushed since last scroll
+
+    QVector<QPointF> mRing; /// - last points, x is bucket position
+    int mHead, mPoints; /// - next position, number of points in ring
+
+    QRect mPlot; /// - plot area
+    QPixmap mBackground; /// - title, grid and labels
+    QPixmap mTrace; /// - trace over transparent plot area
+
+    QVector<HistoryBucket> mColumns; /// - shown columns of history when zoomed
+    int mPressX; /// - x of mouse press, -1 if not pressed
+};
+
+#endif // STRIPCHART_H